@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+// The game replaces the global operator new to count every heap allocation,
+// so the hitch detector can tell which frames allocated. Counting is one
+// relaxed atomic add, cheap enough to leave on in release builds.
+
+// Allocations since the program started, on all threads.
+std::uint64_t getAllocationCount();
+std::uint64_t getAllocatedBytes();
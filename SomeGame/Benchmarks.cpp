@@ -0,0 +1,315 @@
+#include "Benchmarks.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <SFML/Graphics/CircleShape.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
+
+#include "CircleRenderer.h"
+#include "FastMath.h"
+#include "ProjectileKernels.h"
+#include "ProjectilePool.h"
+
+namespace
+{
+	using BenchmarkClock = std::chrono::steady_clock;
+
+	constexpr float benchmarkDeltaSeconds = 1.f / 60.f;
+	const sf::Vector2f benchmarkBounds{ 800.f, 600.f };
+
+	void fillProjectiles(ProjectilePool& projectiles, std::size_t count)
+	{
+		std::mt19937 random{ 42 };
+		std::uniform_real_distribution<float> positionX{ 0.f, benchmarkBounds.x };
+		std::uniform_real_distribution<float> positionY{ 0.f, benchmarkBounds.y };
+		std::uniform_real_distribution<float> speed{ 100.f, 1000.f };
+
+		projectiles.clear();
+		for (std::size_t i = 0; i < count; i++)
+		{
+			const sf::Vector2f position{ positionX(random), positionY(random) };
+			const sf::Vector2f target{ positionX(random), positionY(random) };
+			projectiles.spawn(position, { position, target, speed(random), TargetMode::FlyThrough }, 5.f);
+		}
+	}
+}
+
+int runKernelBenchmark()
+{
+	constexpr std::size_t counts[] = { 10'000, 100'000, 1'000'000 };
+	constexpr std::size_t projectilesPerCount = 200'000'000;
+
+	const auto bestLevel = detectKernelLevel();
+	std::cout << "Projectile integration, best kernel: " << toString(bestLevel) << "\n";
+	std::cout << std::left << std::setw(12) << "projectiles"
+		<< std::setw(8) << "kernel"
+		<< std::setw(14) << "ns/frame"
+		<< "Mprojectiles/s\n";
+
+	for (const auto count : counts)
+	{
+		ProjectilePool projectiles{ count };
+		const auto frames = projectilesPerCount / count;
+
+		for (auto level = KernelLevel::Scalar; level <= bestLevel;
+			level = static_cast<KernelLevel>(static_cast<int>(level) + 1))
+		{
+			fillProjectiles(projectiles, count);
+
+			const auto start = BenchmarkClock::now();
+			for (std::size_t frame = 0; frame < frames; frame++)
+			{
+				// Alternate direction so projectiles oscillate instead of drifting to infinity.
+				const auto deltaSeconds = frame % 2 == 0 ? benchmarkDeltaSeconds : -benchmarkDeltaSeconds;
+				integrateProjectiles(projectiles.getSpan(), deltaSeconds, benchmarkBounds, level);
+			}
+			const std::chrono::duration<double, std::nano> elapsed = BenchmarkClock::now() - start;
+
+			const auto nanosecondsPerFrame = elapsed.count() / static_cast<double>(frames);
+			const auto projectilesPerSecond = static_cast<double>(count) / nanosecondsPerFrame * 1e3;
+			std::cout << std::left << std::setw(12) << count
+				<< std::setw(8) << toString(level)
+				<< std::setw(14) << std::fixed << std::setprecision(0) << nanosecondsPerFrame
+				<< std::setprecision(1) << projectilesPerSecond << "\n";
+		}
+	}
+
+	return 0;
+}
+
+int runRenderBenchmark()
+{
+	constexpr std::size_t counts[] = { 1'000, 10'000, 100'000 };
+	constexpr std::size_t frames = 30;
+	constexpr float radius = 5.f;
+
+	sf::RenderTexture target{ { static_cast<unsigned int>(benchmarkBounds.x), static_cast<unsigned int>(benchmarkBounds.y) } };
+
+	sf::CircleShape shape{ radius };
+	shape.setFillColor(sf::Color::White);
+	shape.setOrigin({ radius, radius });
+	CircleRenderer renderer;
+
+	std::cout << "Projectile rendering, " << frames << " frames each\n";
+	std::cout << std::left << std::setw(12) << "projectiles"
+		<< std::setw(12) << "renderer"
+		<< std::setw(14) << "draws/frame"
+		<< "ms/frame\n";
+
+	const auto report = [](std::size_t count, const char* name, std::size_t drawCalls, double milliseconds)
+	{
+		std::cout << std::left << std::setw(12) << count
+			<< std::setw(12) << name
+			<< std::setw(14) << drawCalls
+			<< std::fixed << std::setprecision(3) << milliseconds << "\n";
+	};
+
+	for (const auto count : counts)
+	{
+		ProjectilePool projectiles{ count };
+		fillProjectiles(projectiles, count);
+
+		auto start = BenchmarkClock::now();
+		for (std::size_t frame = 0; frame < frames; frame++)
+		{
+			target.clear();
+			for (std::size_t i = 0; i < projectiles.size(); i++)
+			{
+				shape.setPosition(projectiles.getPosition(i));
+				target.draw(shape);
+			}
+			target.display();
+		}
+		// Reading the pixels back waits for the GPU to finish every queued frame.
+		(void)target.getTexture().copyToImage();
+		std::chrono::duration<double, std::milli> elapsed = BenchmarkClock::now() - start;
+		report(count, "shapes", count, elapsed.count() / frames);
+
+		start = BenchmarkClock::now();
+		for (std::size_t frame = 0; frame < frames; frame++)
+		{
+			target.clear();
+			renderer.clear();
+			renderer.append(projectiles, sf::Color::White);
+			target.draw(renderer);
+			target.display();
+		}
+		(void)target.getTexture().copyToImage();
+		elapsed = BenchmarkClock::now() - start;
+		report(count, "batched", 1, elapsed.count() / frames);
+	}
+
+	return 0;
+}
+
+int runTrigBenchmark()
+{
+	// Small enough to stay in cache, so the rows compare arithmetic, not memory.
+	constexpr std::size_t count = 4096;
+	constexpr std::size_t repeats = 4000;
+
+	std::mt19937 random{ 42 };
+	std::uniform_real_distribution<float> angle{ -100.f, 100.f };
+	std::uniform_real_distribution<float> coordinate{ -1000.f, 1000.f };
+	std::uniform_real_distribution<float> magnitude{ 1.f, 1e6f };
+	std::vector<float> angles(count), y(count), x(count), values(count);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		angles[i] = angle(random);
+		y[i] = coordinate(random);
+		x[i] = coordinate(random);
+		values[i] = magnitude(random);
+	}
+	std::vector<float> first(count), second(count);
+
+	const auto bestLevel = detectKernelLevel();
+	std::cout << "Trigonometry, " << count * repeats / 1'000'000 << "M values per row, best kernel: " << toString(bestLevel) << "\n";
+	std::cout << std::left << std::setw(10) << "function"
+		<< std::setw(10) << "variant"
+		<< std::setw(12) << "ns/value"
+		<< "speedup\n";
+
+	// Every row reads its results back, so the loops can't be dropped.
+	double sink = 0.0;
+	const auto measure = [&](const std::function<void()>& run)
+	{
+		const auto start = BenchmarkClock::now();
+		for (std::size_t repeat = 0; repeat < repeats; repeat++)
+			run();
+		const std::chrono::duration<double, std::nano> elapsed = BenchmarkClock::now() - start;
+		sink += first[count / 2];
+		return elapsed.count() / static_cast<double>(count * repeats);
+	};
+
+	const auto benchmark = [&](const char* function,
+		const std::function<void()>& standard,
+		const std::function<void()>& inlineForm,
+		const std::function<void(KernelLevel)>& arrayForm)
+	{
+		const auto standardNanoseconds = measure(standard);
+		const auto report = [&](const char* variant, double nanoseconds)
+		{
+			std::cout << std::left << std::setw(10) << function
+				<< std::setw(10) << variant
+				<< std::setw(12) << std::fixed << std::setprecision(2) << nanoseconds
+				<< std::setprecision(1) << standardNanoseconds / nanoseconds << "x\n";
+		};
+
+		report("std", standardNanoseconds);
+		report("inline", measure(inlineForm));
+		for (auto level = KernelLevel::Scalar; level <= bestLevel;
+			level = static_cast<KernelLevel>(static_cast<int>(level) + 1))
+		{
+			report(toString(level), measure([&] { arrayForm(level); }));
+		}
+	};
+
+	benchmark("sincos",
+		[&] { for (std::size_t i = 0; i < count; i++) { first[i] = std::sin(angles[i]); second[i] = std::cos(angles[i]); } },
+		[&] { for (std::size_t i = 0; i < count; i++) fastSinCos(angles[i], first[i], second[i]); },
+		[&](KernelLevel level) { fastSinCos(angles.data(), first.data(), second.data(), count, level); });
+	benchmark("atan2",
+		[&] { for (std::size_t i = 0; i < count; i++) first[i] = std::atan2(y[i], x[i]); },
+		[&] { for (std::size_t i = 0; i < count; i++) first[i] = fastAtan2(y[i], x[i]); },
+		[&](KernelLevel level) { fastAtan2(y.data(), x.data(), first.data(), count, level); });
+	benchmark("rsqrt",
+		[&] { for (std::size_t i = 0; i < count; i++) first[i] = 1.f / std::sqrt(values[i]); },
+		[&] { for (std::size_t i = 0; i < count; i++) first[i] = fastRsqrt(values[i]); },
+		[&](KernelLevel level) { fastRsqrt(values.data(), first.data(), count, level); });
+
+	// Error bounds, over the whole documented range and against double
+	// precision results. The inline form is checked like a kernel level.
+	constexpr std::size_t checkCount = 1 << 20;
+	constexpr double twoPi = 6.283185307179586;
+	std::vector<float> checkAngles(checkCount), checkY(checkCount), checkX(checkCount), checkValues(checkCount);
+	for (std::size_t i = 0; i < checkCount; i++)
+	{
+		const auto t = static_cast<double>(i) / static_cast<double>(checkCount - 1);
+		checkAngles[i] = static_cast<float>((2.0 * t - 1.0) * fastTrigMaxArgument);
+		// Around the circle at radii from 1e-3 to 1e3.
+		const auto radius = std::pow(10.0, static_cast<double>(i % 7) - 3.0);
+		checkY[i] = static_cast<float>(radius * std::sin(t * twoPi));
+		checkX[i] = static_cast<float>(radius * std::cos(t * twoPi));
+		checkValues[i] = static_cast<float>(std::pow(10.0, 60.0 * t - 30.0));
+	}
+	std::vector<float> sines(checkCount), cosines(checkCount), results(checkCount);
+
+	std::cout << "Error bounds, " << checkCount << " values each\n";
+	bool withinBounds = true;
+	const auto check = [&](const std::string& name, double maxError, float bound)
+	{
+		const auto ok = maxError <= static_cast<double>(bound);
+		withinBounds = withinBounds && ok;
+		std::cout << std::left << std::setw(20) << name
+			<< std::scientific << std::setprecision(2) << maxError << " <= " << bound
+			<< (ok ? "  ok\n" : "  FAILED\n");
+	};
+
+	// compute fills sines, cosines and the atan2 results, then the rsqrt results.
+	const auto checkVariant = [&](const std::string& variant, const std::function<void()>& computeTrig, const std::function<void()>& computeRsqrt)
+	{
+		computeTrig();
+		double sinCosError = 0.0;
+		double atan2Error = 0.0;
+		for (std::size_t i = 0; i < checkCount; i++)
+		{
+			const auto a = static_cast<double>(checkAngles[i]);
+			sinCosError = std::max({ sinCosError, std::abs(sines[i] - std::sin(a)), std::abs(cosines[i] - std::cos(a)) });
+
+			// Both ends of the range are the same angle.
+			auto difference = std::abs(results[i] - std::atan2(static_cast<double>(checkY[i]), static_cast<double>(checkX[i])));
+			difference = std::min(difference, twoPi - difference);
+			atan2Error = std::max(atan2Error, difference);
+		}
+
+		computeRsqrt();
+		double rsqrtError = 0.0;
+		for (std::size_t i = 0; i < checkCount; i++)
+		{
+			const auto exact = 1.0 / std::sqrt(static_cast<double>(checkValues[i]));
+			rsqrtError = std::max(rsqrtError, std::abs(results[i] - exact) / exact);
+		}
+
+		check("sincos " + variant, sinCosError, fastSinCosMaxError);
+		check("atan2 " + variant, atan2Error, fastAtan2MaxError);
+		check("rsqrt " + variant, rsqrtError, fastRsqrtMaxRelativeError);
+	};
+
+	checkVariant("inline",
+		[&]
+		{
+			for (std::size_t i = 0; i < checkCount; i++)
+			{
+				fastSinCos(checkAngles[i], sines[i], cosines[i]);
+				results[i] = fastAtan2(checkY[i], checkX[i]);
+			}
+		},
+		[&] { for (std::size_t i = 0; i < checkCount; i++) results[i] = fastRsqrt(checkValues[i]); });
+	for (auto level = KernelLevel::Scalar; level <= bestLevel;
+		level = static_cast<KernelLevel>(static_cast<int>(level) + 1))
+	{
+		checkVariant(toString(level),
+			[&]
+			{
+				fastSinCos(checkAngles.data(), sines.data(), cosines.data(), checkCount, level);
+				fastAtan2(checkY.data(), checkX.data(), results.data(), checkCount, level);
+			},
+			[&] { fastRsqrt(checkValues.data(), results.data(), checkCount, level); });
+	}
+
+	// Keeps the benchmarked loops alive.
+	if (sink == 0.0)
+		std::cout << "";
+
+	return withinBounds ? 0 : 1;
+}
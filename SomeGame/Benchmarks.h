@@ -0,0 +1,16 @@
+#pragma once
+
+// Command line benchmarks, run with `SomeGame --bench-<name>` instead of the game.
+
+// Projectile integration throughput per kernel level at 10k/100k/1M projectiles.
+int runKernelBenchmark();
+
+// Per-projectile sf::CircleShape draws against one batched ProjectileRenderer
+// draw, rendered offscreen into an sf::RenderTexture at 1k-100k projectiles.
+// Needs an OpenGL context but no window, so it also runs under Mesa/llvmpipe.
+int runRenderBenchmark();
+
+// Standard library sin/cos, atan2 and 1/sqrt against the FastMath inline and
+// array forms at every kernel level, then checks every form against its
+// documented error bound. Returns 1 when a bound doesn't hold.
+int runTrigBenchmark();
@@ -0,0 +1,113 @@
+#include "BulletPattern.h"
+
+#include <cmath>
+
+#include "FastMath.h"
+
+namespace
+{
+	constexpr double twoPi = 6.283185307179586;
+	constexpr double fullTurn = 4294967296.0; // 2^32
+
+	struct NamedPattern
+	{
+		std::string_view Name;
+		BulletPattern Pattern;
+	};
+
+	const NamedPattern namedPatterns[]
+	{
+		{ "radial", { .Shape = PatternShape::Radial, .Count = 32, .Speed = 200.f, .VolleyInterval = 0.5f } },
+		{ "spiral", { .Shape = PatternShape::Radial, .Count = 6, .Speed = 180.f, .Spin = 0.2f, .VolleyInterval = 0.05f } },
+		{ "fan", { .Shape = PatternShape::Fan, .Count = 9, .Speed = 250.f, .Spread = 1.f, .VolleyInterval = 0.3f } },
+		{ "burst", { .Shape = PatternShape::AimedBurst, .Count = 5, .Speed = 200.f, .SpeedStep = 40.f, .VolleyInterval = 0.6f } },
+	};
+}
+
+BinaryAngle toBinaryAngle(float radians)
+{
+	// Through a signed 64-bit value so negative angles wrap like positive ones.
+	return static_cast<BinaryAngle>(static_cast<std::int64_t>(std::llround(radians / twoPi * fullTurn)));
+}
+
+DirectionTable::DirectionTable()
+{
+	for (std::size_t i = 0; i < size; i++)
+	{
+		const auto angle = twoPi * static_cast<double>(i) / static_cast<double>(size);
+		Cos[i] = static_cast<float>(std::cos(angle));
+		Sin[i] = static_cast<float>(std::sin(angle));
+	}
+}
+
+const DirectionTable& getDirectionTable()
+{
+	static const DirectionTable table;
+	return table;
+}
+
+std::optional<BulletPattern> findBulletPattern(std::string_view name)
+{
+	for (const auto& named : namedPatterns)
+	{
+		if (named.Name == name)
+			return named.Pattern;
+	}
+
+	return std::nullopt;
+}
+
+PatternEmitter::PatternEmitter(const BulletPattern& pattern)
+	: Pattern(pattern),
+	Timer(pattern.VolleyInterval),
+	SpinAngle(toBinaryAngle(pattern.Spin)),
+	SpreadAngle(toBinaryAngle(pattern.Spread))
+{
+}
+
+std::size_t PatternEmitter::emit(ProjectilePool& pool, sf::Vector2f origin, sf::Vector2f target, float delaySeconds) const
+{
+	if (Pattern.Count == 0)
+		return 0;
+
+	const auto projectiles = pool.spawnSpan(Pattern.Count);
+	if (projectiles.Count == 0)
+		return 0;
+
+	// One atan2 per volley for the aim, the directions come from the table.
+	auto first = Phase;
+	BinaryAngle step{};
+	if (Pattern.Shape == PatternShape::Radial)
+	{
+		// A full turn is one past the largest angle, so one projectile gets a step of 0.
+		step = static_cast<BinaryAngle>((std::uint64_t{ 1 } << 32) / Pattern.Count);
+	}
+	else
+	{
+		const auto toTarget = target - origin;
+		first += toBinaryAngle(fastAtan2(toTarget.y, toTarget.x));
+		if (Pattern.Shape == PatternShape::Fan && Pattern.Count > 1)
+		{
+			step = SpreadAngle / static_cast<BinaryAngle>(Pattern.Count - 1);
+			first -= SpreadAngle / 2;
+		}
+	}
+
+	const auto& directions = getDirectionTable();
+	for (std::size_t i = 0; i < projectiles.Count; i++)
+	{
+		const auto direction = directions[first + static_cast<BinaryAngle>(i) * step];
+		const auto speed = Pattern.Speed + Pattern.SpeedStep * static_cast<float>(i);
+		projectiles.VelocityX[i] = direction.x * speed;
+		projectiles.VelocityY[i] = direction.y * speed;
+		projectiles.X[i] = origin.x - projectiles.VelocityX[i] * delaySeconds;
+		projectiles.Y[i] = origin.y - projectiles.VelocityY[i] * delaySeconds;
+		projectiles.PreviousX[i] = projectiles.X[i];
+		projectiles.PreviousY[i] = projectiles.Y[i];
+		projectiles.Radius[i] = Pattern.Radius;
+		projectiles.TimeToTarget[i] = neverReachesTarget;
+		projectiles.Age[i] = -delaySeconds;
+	}
+
+	return projectiles.Count;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include <SFML/System/Vector2.hpp>
+
+#include "ProjectilePool.h"
+#include "WeaponEmitter.h"
+
+// Angles as fractions of a full turn over the whole 32-bit range, so adding
+// them wraps around the circle for free and the top bits index the table.
+using BinaryAngle = std::uint32_t;
+
+BinaryAngle toBinaryAngle(float radians);
+
+// Unit directions for every DirectionTable::size-th of a turn, computed once.
+struct DirectionTable
+{
+	static constexpr std::size_t size = 4096;
+	static constexpr int indexShift = 20; // 32 bits of angle down to 12 bits of index
+
+	std::array<float, size> Cos{};
+	std::array<float, size> Sin{};
+
+	DirectionTable();
+
+	sf::Vector2f operator[](BinaryAngle angle) const
+	{
+		// Nearest entry, not the one below. The addition wraps, so angles in
+		// the last half step round to entry 0 and the index stays in range.
+		const auto index = static_cast<BinaryAngle>(angle + (BinaryAngle{ 1 } << (indexShift - 1))) >> indexShift;
+		return { Cos[index], Sin[index] };
+	}
+};
+
+const DirectionTable& getDirectionTable();
+
+enum class PatternShape
+{
+	Radial,     // evenly around the full circle; turning it each volley makes a spiral
+	Fan,        // evenly over Spread, centered on the target
+	AimedBurst, // all at the target, each SpeedStep faster than the one before
+};
+
+// What one volley looks like and how often they come. Everything a pattern
+// is lives here, so new patterns are data, not code.
+struct BulletPattern
+{
+	PatternShape Shape = PatternShape::Radial;
+	std::size_t Count = 1; // projectiles per volley
+	float Speed = 200.f;
+	float SpeedStep = 0.f;
+	float Spread = 0.f; // radians
+	float Spin = 0.f; // radians the pattern turns after each volley
+	float VolleyInterval = 0.1f; // seconds
+	float Radius = 4.f;
+};
+
+// The presets radial, spiral, fan and burst, or nothing for any other name.
+std::optional<BulletPattern> findBulletPattern(std::string_view name);
+
+// Fires a pattern's volleys on its own clock. update() says when a volley
+// is due; emit() writes one volley from an origin straight into a pool's
+// columns, so a volley is one loop over the table and no spawn calls.
+class PatternEmitter
+{
+public:
+	explicit PatternEmitter(const BulletPattern& pattern);
+
+	// Calls volley(delaySeconds) for each volley due this step, in order,
+	// with the time from the start of the step to the volley. The pattern
+	// turns by its Spin after each one.
+	template <typename Volley>
+	int update(float deltaSeconds, bool triggerHeld, Volley&& volley)
+	{
+		return Timer.update(deltaSeconds, triggerHeld, [&](float delaySeconds)
+		{
+			volley(delaySeconds);
+			Phase += SpinAngle;
+		});
+	}
+
+	// Writes one volley fired delaySeconds into the coming update, placed
+	// back along each path like ProjectilePool::spawn(). Fans and bursts aim
+	// at target. Returns how many projectiles fit into the pool.
+	std::size_t emit(ProjectilePool& pool, sf::Vector2f origin, sf::Vector2f target, float delaySeconds) const;
+
+	const BulletPattern& getPattern() const { return Pattern; }
+	BinaryAngle getPhase() const { return Phase; }
+	float getCooldown() const { return Timer.getCooldown(); }
+
+private:
+	BulletPattern Pattern;
+	WeaponEmitter Timer;
+	BinaryAngle SpinAngle{};
+	BinaryAngle SpreadAngle{};
+	BinaryAngle Phase{};
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cmath>
+#include <optional>
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+// Every collider in the game is a circle, so entities keep their center and
+// radius directly. The bounding box is recomputed only when the circle moves,
+// instead of going through a shape's transform on every getGlobalBounds().
+class CircleCollider
+{
+public:
+	CircleCollider(sf::Vector2f center, float radius)
+		: Center(center), Radius(radius)
+	{
+		updateBounds();
+	}
+
+	sf::Vector2f getCenter() const { return Center; }
+	float getRadius() const { return Radius; }
+	const sf::FloatRect& getBounds() const { return Bounds; }
+
+	void setCenter(sf::Vector2f center)
+	{
+		Center = center;
+		updateBounds();
+	}
+
+	void move(sf::Vector2f offset) { setCenter(Center + offset); }
+
+	bool intersects(const CircleCollider& other) const
+	{
+		return intersects(Center, Radius, other.Center, other.Radius);
+	}
+
+	// Exact circle test on squared distances, touching counts as a hit.
+	static bool intersects(sf::Vector2f centerA, float radiusA, sf::Vector2f centerB, float radiusB)
+	{
+		const auto radii = radiusA + radiusB;
+		return (centerB - centerA).lengthSquared() <= radii * radii;
+	}
+
+	// Continuous test for two circles moving in straight lines from their start
+	// to their end centers over one step. Returns the earliest time in [0, 1]
+	// at which they touch, so fast circles can't pass through each other
+	// between steps.
+	static std::optional<float> sweep(
+		sf::Vector2f startA, sf::Vector2f endA, float radiusA,
+		sf::Vector2f startB, sf::Vector2f endB, float radiusB)
+	{
+		// Solve |offset + motion * t| = radii with B at rest and A carrying the relative motion.
+		const auto offset = startA - startB;
+		const auto motion = (endA - startA) - (endB - startB);
+		const auto radii = radiusA + radiusB;
+
+		const auto c = offset.lengthSquared() - radii * radii;
+		if (c <= 0.f)
+			return 0.f;
+
+		const auto a = motion.lengthSquared();
+		const auto b = offset.dot(motion);
+		if (a == 0.f || b >= 0.f)
+			return std::nullopt; // not closing in
+
+		const auto discriminant = b * b - a * c;
+		if (discriminant < 0.f)
+			return std::nullopt;
+
+		const auto timeOfImpact = (-b - std::sqrt(discriminant)) / a;
+		if (timeOfImpact > 1.f)
+			return std::nullopt;
+
+		return timeOfImpact;
+	}
+
+	// Box around everything a circle touches moving from start to end.
+	static sf::FloatRect getSweptBounds(sf::Vector2f start, sf::Vector2f end, float radius)
+	{
+		const sf::Vector2f min{ std::fmin(start.x, end.x) - radius, std::fmin(start.y, end.y) - radius };
+		const sf::Vector2f max{ std::fmax(start.x, end.x) + radius, std::fmax(start.y, end.y) + radius };
+		return { min, max - min };
+	}
+
+private:
+	sf::Vector2f Center{};
+	float Radius{};
+	sf::FloatRect Bounds{};
+
+	void updateBounds()
+	{
+		Bounds = { { Center.x - Radius, Center.y - Radius }, { Radius * 2, Radius * 2 } };
+	}
+};
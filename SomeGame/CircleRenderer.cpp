@@ -0,0 +1,99 @@
+#include "CircleRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <SFML/Graphics/RenderTarget.hpp>
+
+#include "GameConfig.h"
+
+CircleRenderer::CircleRenderer(std::size_t segments)
+{
+	constexpr float twoPi = 6.28318530718f;
+
+	segments = std::max<std::size_t>(segments, 3);
+	UnitCircle.reserve(segments + 1);
+	for (std::size_t i = 0; i <= segments; i++)
+	{
+		const auto angle = twoPi * static_cast<float>(i) / static_cast<float>(segments);
+		UnitCircle.push_back({ std::cos(angle), std::sin(angle) });
+	}
+}
+
+void CircleRenderer::clear()
+{
+	VertexCount = 0;
+	CircleCount = 0;
+}
+
+void CircleRenderer::append(const ProjectilePool& projectiles, sf::Color color, float interpolation)
+{
+	reserve(projectiles.size());
+	writeProjectiles(VertexCount, projectiles, 0, projectiles.size(), color, interpolation);
+	VertexCount += projectiles.size() * getVerticesPerCircle();
+	CircleCount += projectiles.size();
+}
+
+void CircleRenderer::append(const ProjectilePool& projectiles, sf::Color color, float interpolation, JobSystem& jobs)
+{
+	reserve(projectiles.size());
+
+	// Every chunk writes its own range of the already sized vertex array.
+	const auto firstVertex = VertexCount;
+	jobs.parallelFor(projectiles.size(), parallelChunkSize, [&](std::size_t first, std::size_t count)
+	{
+		writeProjectiles(firstVertex + first * getVerticesPerCircle(), projectiles, first, count, color, interpolation);
+	});
+
+	VertexCount += projectiles.size() * getVerticesPerCircle();
+	CircleCount += projectiles.size();
+}
+
+void CircleRenderer::appendCircle(sf::Vector2f center, float radius, sf::Color color)
+{
+	reserve(1);
+	writeCircle(VertexCount, center, radius, color);
+	VertexCount += getVerticesPerCircle();
+	CircleCount++;
+}
+
+void CircleRenderer::reserve(std::size_t circles)
+{
+	const auto required = VertexCount + circles * getVerticesPerCircle();
+	if (required > Vertices.getVertexCount())
+		Vertices.resize(std::max(required, Vertices.getVertexCount() * 2));
+}
+
+void CircleRenderer::writeCircle(std::size_t firstVertex, sf::Vector2f center, float radius, sf::Color color)
+{
+	// Fan of triangles around the center, one per segment.
+	const auto segments = UnitCircle.size() - 1;
+	auto* triangle = &Vertices[firstVertex];
+	for (std::size_t segment = 0; segment < segments; segment++, triangle += 3)
+	{
+		triangle[0].position = center;
+		triangle[1].position = center + UnitCircle[segment] * radius;
+		triangle[2].position = center + UnitCircle[segment + 1] * radius;
+		triangle[0].color = triangle[1].color = triangle[2].color = color;
+	}
+}
+
+void CircleRenderer::writeProjectiles(
+	std::size_t firstVertex,
+	const ProjectilePool& projectiles,
+	std::size_t first,
+	std::size_t count,
+	sf::Color color,
+	float interpolation)
+{
+	for (auto i = first; i < first + count; i++, firstVertex += getVerticesPerCircle())
+		writeCircle(firstVertex, projectiles.getInterpolatedPosition(i, interpolation), projectiles.Radius[i], color);
+}
+
+void CircleRenderer::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	if (VertexCount == 0)
+		return;
+
+	target.draw(&Vertices[0], VertexCount, sf::PrimitiveType::Triangles, states);
+}
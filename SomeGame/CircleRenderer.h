@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include "JobSystem.h"
+#include "ProjectilePool.h"
+
+// Draws any number of filled circles with a single draw call.
+// Each frame, clear() then append() the pools and circles to draw; every
+// circle becomes a low-poly fan written straight into one vertex array. The
+// array only ever grows, so steady-state frames don't allocate.
+// interpolation blends from the previous to the current simulation step.
+class CircleRenderer : public sf::Drawable
+{
+public:
+	explicit CircleRenderer(std::size_t segments = 8);
+
+	void clear();
+	void append(const ProjectilePool& projectiles, sf::Color color, float interpolation = 1.f);
+	// Same, with the vertices written in chunks across the job system's threads.
+	void append(const ProjectilePool& projectiles, sf::Color color, float interpolation, JobSystem& jobs);
+	void appendCircle(sf::Vector2f center, float radius, sf::Color color);
+
+	std::size_t getCircleCount() const { return CircleCount; }
+
+private:
+	sf::VertexArray Vertices{ sf::PrimitiveType::Triangles };
+	std::vector<sf::Vector2f> UnitCircle;
+	std::size_t VertexCount{};
+	std::size_t CircleCount{};
+
+	std::size_t getVerticesPerCircle() const { return (UnitCircle.size() - 1) * 3; }
+	void reserve(std::size_t circles);
+	void writeCircle(std::size_t firstVertex, sf::Vector2f center, float radius, sf::Color color);
+	void writeProjectiles(std::size_t firstVertex, const ProjectilePool& projectiles, std::size_t first, std::size_t count, sf::Color color, float interpolation);
+	void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include "CircleCollider.h"
+#include "Ecs.h"
+#include "MovementModels.h"
+#include "ProjectileBuckets.h"
+
+// Components are plain data; systems give them behaviour. CircleCollider is a
+// component as well and is the position of every entity.
+
+struct PreviousCenter
+{
+	sf::Vector2f Value{}; // collider center at the start of the last step
+};
+
+struct Health
+{
+	int Hp{};
+};
+
+struct Patrol
+{
+	bool IsPathingDown = true;
+};
+
+struct Appearance
+{
+	sf::Color Color{};
+};
+
+// Small dot drawn on top of an entity's center.
+struct CenterMarker
+{
+	float Radius{};
+	sf::Color Color{};
+};
+
+using PlayerArchetype = Archetype<CircleCollider, PreviousCenter, Appearance, CenterMarker>;
+using EnemyArchetype = Archetype<CircleCollider, PreviousCenter, Appearance, Health, Patrol>;
+
+// Projectiles are their own SIMD-friendly archetype: one ProjectilePool of
+// columns per movement model. Number keys 1-5 pick the model in this order.
+using PlayerProjectiles = ProjectileBuckets<
+	LinearMovement,
+	HomingMovement,
+	BallisticMovement,
+	SineWaveMovement,
+	SpiralMovement>;
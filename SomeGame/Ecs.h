@@ -0,0 +1,240 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "JobSystem.h"
+
+// A small archetype ECS. Each Archetype<Components...> stores one kind of
+// entity as a column per component, packed and preallocated, and systems are
+// plain functions that run over the columns they ask for. Entity handles are
+// generational, so handles to despawned entities stop resolving.
+
+constexpr std::size_t cacheLineSize = 64;
+
+// Keeps every column on its own cache lines so chunks handed to different
+// threads never share one at the start of a column.
+template <typename T>
+struct CacheAlignedAllocator
+{
+	using value_type = T;
+
+	CacheAlignedAllocator() = default;
+
+	template <typename U>
+	CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+	T* allocate(std::size_t count)
+	{
+		return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{ cacheLineSize }));
+	}
+
+	void deallocate(T* pointer, std::size_t)
+	{
+		::operator delete(pointer, std::align_val_t{ cacheLineSize });
+	}
+
+	template <typename U>
+	bool operator==(const CacheAlignedAllocator<U>&) const { return true; }
+};
+
+template <typename Component>
+using Column = std::vector<Component, CacheAlignedAllocator<Component>>;
+
+struct Entity
+{
+	std::uint32_t Slot{};
+	std::uint32_t Generation{};
+
+	bool operator==(const Entity&) const = default;
+};
+
+template <typename... Components>
+class Archetype
+{
+public:
+	template <typename Component>
+	static constexpr bool has = (std::is_same_v<Component, Components> || ...);
+
+	explicit Archetype(std::size_t capacity)
+		: Slots(capacity)
+	{
+		std::apply([&](auto&... columns) { (columns.reserve(capacity), ...); }, Columns);
+		PackedSlots.reserve(capacity);
+		FreeSlots.reserve(capacity);
+		for (auto slot = static_cast<std::uint32_t>(capacity); slot > 0; slot--)
+			FreeSlots.push_back(slot - 1);
+	}
+
+	// Returns nothing when the archetype is full.
+	std::optional<Entity> spawn(Components... components)
+	{
+		if (FreeSlots.empty())
+			return std::nullopt;
+
+		const auto slot = FreeSlots.back();
+		FreeSlots.pop_back();
+
+		Slots[slot].PackedIndex = static_cast<std::uint32_t>(size());
+		(column<Components>().push_back(std::move(components)), ...);
+		PackedSlots.push_back(slot);
+		return Entity{ slot, Slots[slot].Generation };
+	}
+
+	bool despawn(Entity entity)
+	{
+		if (!isAlive(entity))
+			return false;
+
+		despawnAt(Slots[entity.Slot].PackedIndex);
+		return true;
+	}
+
+	// Despawns every entity for which predicate(index) is true, in one pass.
+	template <typename Predicate>
+	void despawnIf(Predicate&& predicate)
+	{
+		for (std::size_t i = 0; i < size();)
+		{
+			if (predicate(i))
+			{
+				despawnAt(static_cast<std::uint32_t>(i));
+				continue;
+			}
+			++i;
+		}
+	}
+
+	bool isAlive(Entity entity) const
+	{
+		return entity.Slot < Slots.size() && Slots[entity.Slot].Generation == entity.Generation
+			&& Slots[entity.Slot].PackedIndex != freeSlot;
+	}
+
+	// Packed index of a live entity. Indices are only stable until the next despawn.
+	std::optional<std::size_t> indexOf(Entity entity) const
+	{
+		if (!isAlive(entity))
+			return std::nullopt;
+		return Slots[entity.Slot].PackedIndex;
+	}
+
+	Entity getEntity(std::size_t index) const
+	{
+		const auto slot = PackedSlots[index];
+		return { slot, Slots[slot].Generation };
+	}
+
+	template <typename Component>
+	Column<Component>& column() { return std::get<Column<Component>>(Columns); }
+
+	template <typename Component>
+	const Column<Component>& column() const { return std::get<Column<Component>>(Columns); }
+
+	template <typename Component>
+	Component& get(std::size_t index) { return column<Component>()[index]; }
+
+	template <typename Component>
+	const Component& get(std::size_t index) const { return column<Component>()[index]; }
+
+	std::size_t size() const { return PackedSlots.size(); }
+	std::size_t capacity() const { return Slots.size(); }
+	bool empty() const { return PackedSlots.empty(); }
+
+	// Calls function(Selected&...) for every entity.
+	template <typename... Selected, typename Function>
+	void forEach(Function&& function)
+	{
+		auto pointers = std::make_tuple(column<Selected>().data()...);
+		const auto count = size();
+		for (std::size_t i = 0; i < count; i++)
+			function(std::get<Selected*>(pointers)[i]...);
+	}
+
+	template <typename... Selected, typename Function>
+	void forEach(Function&& function) const
+	{
+		auto pointers = std::make_tuple(column<Selected>().data()...);
+		const auto count = size();
+		for (std::size_t i = 0; i < count; i++)
+			function(std::get<const Selected*>(pointers)[i]...);
+	}
+
+	// Calls function(count, Selected*...) with the columns of each run of up
+	// to chunkSize entities; the pointers start at the chunk's first entity.
+	template <typename... Selected, typename Function>
+	void forEachChunk(std::size_t chunkSize, Function&& function)
+	{
+		const auto count = size();
+		for (std::size_t first = 0; first < count; first += chunkSize)
+			function(std::min(chunkSize, count - first), (column<Selected>().data() + first)...);
+	}
+
+	// forEachChunk with the chunks spread over the job system's threads.
+	// function runs concurrently and may only touch the entities of the chunk
+	// it was given.
+	template <typename... Selected, typename Function>
+	void parallelForEachChunk(JobSystem& jobs, std::size_t chunkSize, Function&& function)
+	{
+		jobs.parallelFor(size(), chunkSize, [&](std::size_t first, std::size_t count)
+		{
+			function(count, (column<Selected>().data() + first)...);
+		});
+	}
+
+private:
+	static constexpr std::uint32_t freeSlot = ~std::uint32_t{};
+
+	struct Slot
+	{
+		std::uint32_t PackedIndex = freeSlot;
+		std::uint32_t Generation{};
+	};
+
+	std::tuple<Column<Components>...> Columns;
+	std::vector<std::uint32_t> PackedSlots; // slot of every packed entity
+	std::vector<Slot> Slots;
+	std::vector<std::uint32_t> FreeSlots;
+
+	void despawnAt(std::uint32_t index)
+	{
+		assert(index < size());
+
+		const auto slot = PackedSlots[index];
+		const auto last = static_cast<std::uint32_t>(size() - 1);
+		if (index != last)
+		{
+			((column<Components>()[index] = std::move(column<Components>()[last])), ...);
+			PackedSlots[index] = PackedSlots[last];
+			Slots[PackedSlots[index]].PackedIndex = index;
+		}
+
+		(column<Components>().pop_back(), ...);
+		PackedSlots.pop_back();
+
+		Slots[slot].PackedIndex = freeSlot;
+		Slots[slot].Generation++;
+		FreeSlots.push_back(slot);
+	}
+};
+
+// Runs function(archetype) on every archetype that has all of Required, so a
+// system can be written once against components instead of entity types.
+template <typename... Required, typename Function, typename... Archetypes>
+void forEachMatching(Function&& function, Archetypes&... archetypes)
+{
+	([&](auto& archetype)
+	{
+		using ArchetypeType = std::remove_cvref_t<decltype(archetype)>;
+		if constexpr ((ArchetypeType::template has<Required> && ...))
+			function(archetype);
+	}(archetypes), ...);
+}
@@ -0,0 +1,300 @@
+#include "FastMath.h"
+
+#include "Simd.h"
+
+namespace
+{
+	using namespace FastMathDetail;
+
+	void sinCosScalar(const float* angles, float* sines, float* cosines, std::size_t first, std::size_t count)
+	{
+		for (auto i = first; i < count; i++)
+		{
+			float sine, cosine;
+			fastSinCos(angles[i], sine, cosine);
+			if (sines)
+				sines[i] = sine;
+			if (cosines)
+				cosines[i] = cosine;
+		}
+	}
+
+	void atan2Scalar(const float* y, const float* x, float* angles, std::size_t first, std::size_t count)
+	{
+		for (auto i = first; i < count; i++)
+			angles[i] = fastAtan2(y[i], x[i]);
+	}
+
+	void rsqrtScalar(const float* values, float* results, std::size_t first, std::size_t count)
+	{
+		for (auto i = first; i < count; i++)
+			results[i] = fastRsqrt(values[i]);
+	}
+
+#if SOMEGAME_X86
+	// SSE2 has no blend, so selects are and/andnot/or.
+	SOMEGAME_TARGET_SSE2
+	__m128 selectSse2(__m128 mask, __m128 ifTrue, __m128 ifFalse)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+	}
+
+	SOMEGAME_TARGET_SSE2
+	void sinCosSse2(const float* angles, float* sines, float* cosines, std::size_t count)
+	{
+		const auto one = _mm_set1_epi32(1);
+		const auto two = _mm_set1_epi32(2);
+
+		std::size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const auto angle = _mm_loadu_ps(angles + i);
+			// Converting rounds to nearest, the default MXCSR mode.
+			const auto quadrant = _mm_cvtps_epi32(_mm_mul_ps(angle, _mm_set1_ps(twoOverPi)));
+			const auto q = _mm_cvtepi32_ps(quadrant);
+			auto r = _mm_sub_ps(angle, _mm_mul_ps(q, _mm_set1_ps(halfPiHigh)));
+			r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(halfPiMiddle)));
+			r = _mm_sub_ps(r, _mm_mul_ps(q, _mm_set1_ps(halfPiLow)));
+			const auto r2 = _mm_mul_ps(r, r);
+
+			auto s = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), r2), _mm_set1_ps(8.3321608736e-3f));
+			s = _mm_sub_ps(_mm_mul_ps(s, r2), _mm_set1_ps(1.6666654611e-1f));
+			s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(s, r2), r), r);
+
+			auto c = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), r2), _mm_set1_ps(1.388731625493765e-3f));
+			c = _mm_add_ps(_mm_mul_ps(c, r2), _mm_set1_ps(4.166664568298827e-2f));
+			c = _mm_mul_ps(_mm_mul_ps(c, r2), r2);
+			c = _mm_add_ps(_mm_sub_ps(c, _mm_mul_ps(_mm_set1_ps(0.5f), r2)), _mm_set1_ps(1.f));
+
+			// Bit 1 of the quadrant moved up to the float sign bit.
+			const auto swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(quadrant, one), one));
+			const auto sineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(quadrant, two), 30));
+			const auto cosineSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(quadrant, one), two), 30));
+			if (sines)
+				_mm_storeu_ps(sines + i, _mm_xor_ps(selectSse2(swap, c, s), sineSign));
+			if (cosines)
+				_mm_storeu_ps(cosines + i, _mm_xor_ps(selectSse2(swap, s, c), cosineSign));
+		}
+
+		sinCosScalar(angles, sines, cosines, i, count);
+	}
+
+	SOMEGAME_TARGET_SSE2
+	void atan2Sse2(const float* y, const float* x, float* angles, std::size_t count)
+	{
+		const auto absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+		const auto signBit = _mm_set1_ps(-0.f);
+		const auto zero = _mm_setzero_ps();
+
+		std::size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const auto vy = _mm_loadu_ps(y + i);
+			const auto vx = _mm_loadu_ps(x + i);
+			const auto absY = _mm_and_ps(vy, absMask);
+			const auto absX = _mm_and_ps(vx, absMask);
+			const auto larger = _mm_max_ps(absX, absY);
+			// 0 / 0 is NaN, masked to 0.
+			const auto a = _mm_and_ps(_mm_div_ps(_mm_min_ps(absX, absY), larger), _mm_cmpgt_ps(larger, zero));
+			const auto a2 = _mm_mul_ps(a, a);
+
+			auto p = _mm_set1_ps(0.0028662257f);
+			p = _mm_sub_ps(_mm_mul_ps(p, a2), _mm_set1_ps(0.0161657367f));
+			p = _mm_add_ps(_mm_mul_ps(p, a2), _mm_set1_ps(0.0429096138f));
+			p = _mm_sub_ps(_mm_mul_ps(p, a2), _mm_set1_ps(0.0752896400f));
+			p = _mm_add_ps(_mm_mul_ps(p, a2), _mm_set1_ps(0.1065626393f));
+			p = _mm_sub_ps(_mm_mul_ps(p, a2), _mm_set1_ps(0.1420889944f));
+			p = _mm_add_ps(_mm_mul_ps(p, a2), _mm_set1_ps(0.1999355085f));
+			p = _mm_sub_ps(_mm_mul_ps(p, a2), _mm_set1_ps(0.3333314528f));
+			auto angle = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, a2), a), a);
+
+			angle = selectSse2(_mm_cmpgt_ps(absY, absX), _mm_sub_ps(_mm_set1_ps(halfPi), angle), angle);
+			angle = selectSse2(_mm_cmplt_ps(vx, zero), _mm_sub_ps(_mm_set1_ps(pi), angle), angle);
+			angle = _mm_xor_ps(angle, _mm_and_ps(_mm_cmplt_ps(vy, zero), signBit));
+			_mm_storeu_ps(angles + i, angle);
+		}
+
+		atan2Scalar(y, x, angles, i, count);
+	}
+
+	SOMEGAME_TARGET_SSE2
+	void rsqrtSse2(const float* values, float* results, std::size_t count)
+	{
+		std::size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			// The 12-bit hardware estimate and one Newton step.
+			const auto value = _mm_loadu_ps(values + i);
+			const auto estimate = _mm_rsqrt_ps(value);
+			const auto correction = _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), value), _mm_mul_ps(estimate, estimate)));
+			_mm_storeu_ps(results + i, _mm_mul_ps(estimate, correction));
+		}
+
+		rsqrtScalar(values, results, i, count);
+	}
+
+	SOMEGAME_TARGET_AVX2
+	void sinCosAvx2(const float* angles, float* sines, float* cosines, std::size_t count)
+	{
+		const auto one = _mm256_set1_epi32(1);
+		const auto two = _mm256_set1_epi32(2);
+
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const auto angle = _mm256_loadu_ps(angles + i);
+			const auto quadrant = _mm256_cvtps_epi32(_mm256_mul_ps(angle, _mm256_set1_ps(twoOverPi)));
+			const auto q = _mm256_cvtepi32_ps(quadrant);
+			auto r = _mm256_fnmadd_ps(q, _mm256_set1_ps(halfPiHigh), angle);
+			r = _mm256_fnmadd_ps(q, _mm256_set1_ps(halfPiMiddle), r);
+			r = _mm256_fnmadd_ps(q, _mm256_set1_ps(halfPiLow), r);
+			const auto r2 = _mm256_mul_ps(r, r);
+
+			auto s = _mm256_fmadd_ps(_mm256_set1_ps(-1.9515295891e-4f), r2, _mm256_set1_ps(8.3321608736e-3f));
+			s = _mm256_fmsub_ps(s, r2, _mm256_set1_ps(1.6666654611e-1f));
+			s = _mm256_fmadd_ps(_mm256_mul_ps(s, r2), r, r);
+
+			auto c = _mm256_fmsub_ps(_mm256_set1_ps(2.443315711809948e-5f), r2, _mm256_set1_ps(1.388731625493765e-3f));
+			c = _mm256_fmadd_ps(c, r2, _mm256_set1_ps(4.166664568298827e-2f));
+			c = _mm256_mul_ps(_mm256_mul_ps(c, r2), r2);
+			c = _mm256_add_ps(_mm256_fnmadd_ps(_mm256_set1_ps(0.5f), r2, c), _mm256_set1_ps(1.f));
+
+			const auto swap = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(quadrant, one), one));
+			const auto sineSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(quadrant, two), 30));
+			const auto cosineSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(_mm256_add_epi32(quadrant, one), two), 30));
+			if (sines)
+				_mm256_storeu_ps(sines + i, _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sineSign));
+			if (cosines)
+				_mm256_storeu_ps(cosines + i, _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cosineSign));
+		}
+
+		// GCC doesn't clear the upper ymm halves in target("avx2") functions;
+		// without this every SSE instruction after the kernel pays a transition.
+		_mm256_zeroupper();
+		sinCosScalar(angles, sines, cosines, i, count);
+	}
+
+	SOMEGAME_TARGET_AVX2
+	void atan2Avx2(const float* y, const float* x, float* angles, std::size_t count)
+	{
+		const auto absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+		const auto signBit = _mm256_set1_ps(-0.f);
+		const auto zero = _mm256_setzero_ps();
+
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const auto vy = _mm256_loadu_ps(y + i);
+			const auto vx = _mm256_loadu_ps(x + i);
+			const auto absY = _mm256_and_ps(vy, absMask);
+			const auto absX = _mm256_and_ps(vx, absMask);
+			const auto larger = _mm256_max_ps(absX, absY);
+			const auto a = _mm256_and_ps(_mm256_div_ps(_mm256_min_ps(absX, absY), larger), _mm256_cmp_ps(larger, zero, _CMP_GT_OQ));
+			const auto a2 = _mm256_mul_ps(a, a);
+
+			auto p = _mm256_set1_ps(0.0028662257f);
+			p = _mm256_fmsub_ps(p, a2, _mm256_set1_ps(0.0161657367f));
+			p = _mm256_fmadd_ps(p, a2, _mm256_set1_ps(0.0429096138f));
+			p = _mm256_fmsub_ps(p, a2, _mm256_set1_ps(0.0752896400f));
+			p = _mm256_fmadd_ps(p, a2, _mm256_set1_ps(0.1065626393f));
+			p = _mm256_fmsub_ps(p, a2, _mm256_set1_ps(0.1420889944f));
+			p = _mm256_fmadd_ps(p, a2, _mm256_set1_ps(0.1999355085f));
+			p = _mm256_fmsub_ps(p, a2, _mm256_set1_ps(0.3333314528f));
+			auto angle = _mm256_fmadd_ps(_mm256_mul_ps(p, a2), a, a);
+
+			angle = _mm256_blendv_ps(angle, _mm256_sub_ps(_mm256_set1_ps(halfPi), angle), _mm256_cmp_ps(absY, absX, _CMP_GT_OQ));
+			angle = _mm256_blendv_ps(angle, _mm256_sub_ps(_mm256_set1_ps(pi), angle), _mm256_cmp_ps(vx, zero, _CMP_LT_OQ));
+			angle = _mm256_xor_ps(angle, _mm256_and_ps(_mm256_cmp_ps(vy, zero, _CMP_LT_OQ), signBit));
+			_mm256_storeu_ps(angles + i, angle);
+		}
+
+		_mm256_zeroupper();
+		atan2Scalar(y, x, angles, i, count);
+	}
+
+	SOMEGAME_TARGET_AVX2
+	void rsqrtAvx2(const float* values, float* results, std::size_t count)
+	{
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const auto value = _mm256_loadu_ps(values + i);
+			const auto estimate = _mm256_rsqrt_ps(value);
+			const auto correction = _mm256_fnmadd_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), value), _mm256_mul_ps(estimate, estimate), _mm256_set1_ps(1.5f));
+			_mm256_storeu_ps(results + i, _mm256_mul_ps(estimate, correction));
+		}
+
+		_mm256_zeroupper();
+		rsqrtScalar(values, results, i, count);
+	}
+#endif
+}
+
+void fastSinCos(const float* angles, float* sines, float* cosines, std::size_t count)
+{
+	fastSinCos(angles, sines, cosines, count, detectKernelLevel());
+}
+
+void fastSinCos(const float* angles, float* sines, float* cosines, std::size_t count, KernelLevel level)
+{
+	switch (level)
+	{
+#if SOMEGAME_X86
+	case KernelLevel::Avx2:
+		sinCosAvx2(angles, sines, cosines, count);
+		return;
+	case KernelLevel::Sse2:
+		sinCosSse2(angles, sines, cosines, count);
+		return;
+#endif
+	default:
+		sinCosScalar(angles, sines, cosines, 0, count);
+		return;
+	}
+}
+
+void fastAtan2(const float* y, const float* x, float* angles, std::size_t count)
+{
+	fastAtan2(y, x, angles, count, detectKernelLevel());
+}
+
+void fastAtan2(const float* y, const float* x, float* angles, std::size_t count, KernelLevel level)
+{
+	switch (level)
+	{
+#if SOMEGAME_X86
+	case KernelLevel::Avx2:
+		atan2Avx2(y, x, angles, count);
+		return;
+	case KernelLevel::Sse2:
+		atan2Sse2(y, x, angles, count);
+		return;
+#endif
+	default:
+		atan2Scalar(y, x, angles, 0, count);
+		return;
+	}
+}
+
+void fastRsqrt(const float* values, float* results, std::size_t count)
+{
+	fastRsqrt(values, results, count, detectKernelLevel());
+}
+
+void fastRsqrt(const float* values, float* results, std::size_t count, KernelLevel level)
+{
+	switch (level)
+	{
+#if SOMEGAME_X86
+	case KernelLevel::Avx2:
+		rsqrtAvx2(values, results, count);
+		return;
+	case KernelLevel::Sse2:
+		rsqrtSse2(values, results, count);
+		return;
+#endif
+	default:
+		rsqrtScalar(values, results, 0, count);
+		return;
+	}
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "ProjectileKernels.h"
+
+// Polynomial approximations of the trigonometry the movement models and
+// emitters need, for arguments that come by the thousand each step. The
+// inline forms are branch-free so loops over them can vectorize; the array
+// forms run explicit SSE2/AVX2 code picked like integrateProjectiles().
+// --bench-trig measures both against the standard library and checks the
+// error bounds below.
+
+// Largest |angle| fastSinCos() keeps within fastSinCosMaxError.
+constexpr float fastTrigMaxArgument = 8192.f;
+constexpr float fastSinCosMaxError = 5e-7f; // absolute
+constexpr float fastAtan2MaxError = 5e-7f; // radians
+constexpr float fastRsqrtMaxRelativeError = 1e-6f; // for positive normal floats
+
+namespace FastMathDetail
+{
+	// pi/2 in three parts, the first two with few enough bits that
+	// multiples of them are exact, so reducing large angles loses little.
+	constexpr float halfPiHigh = 1.5703125f;
+	constexpr float halfPiMiddle = 4.837512969970703125e-4f;
+	constexpr float halfPiLow = 7.54978995489188216e-8f;
+	constexpr float twoOverPi = 0.636619772367581343f;
+	constexpr float halfPi = 1.57079632679489662f;
+	constexpr float pi = 3.14159265358979324f;
+
+	// Minimax polynomials on [-pi/4, pi/4].
+	inline float sinPolynomial(float r, float r2)
+	{
+		return ((-1.9515295891e-4f * r2 + 8.3321608736e-3f) * r2 - 1.6666654611e-1f) * r2 * r + r;
+	}
+
+	inline float cosPolynomial(float r2)
+	{
+		return ((2.443315711809948e-5f * r2 - 1.388731625493765e-3f) * r2 + 4.166664568298827e-2f) * r2 * r2 - 0.5f * r2 + 1.f;
+	}
+
+	// atan on [0, 1], Abramowitz and Stegun 4.4.49.
+	inline float atanPolynomial(float a)
+	{
+		const auto a2 = a * a;
+		auto p = 0.0028662257f;
+		p = p * a2 - 0.0161657367f;
+		p = p * a2 + 0.0429096138f;
+		p = p * a2 - 0.0752896400f;
+		p = p * a2 + 0.1065626393f;
+		p = p * a2 - 0.1420889944f;
+		p = p * a2 + 0.1999355085f;
+		p = p * a2 - 0.3333314528f;
+		return p * a2 * a + a;
+	}
+}
+
+inline void fastSinCos(float angle, float& sine, float& cosine)
+{
+	using namespace FastMathDetail;
+
+	// Nearest quarter turn, then the remainder within an eighth of a turn of it.
+	const auto quadrant = static_cast<std::int32_t>(angle * twoOverPi + std::copysign(0.5f, angle));
+	const auto q = static_cast<float>(quadrant);
+	const auto r = ((angle - q * halfPiHigh) - q * halfPiMiddle) - q * halfPiLow;
+	const auto r2 = r * r;
+	const auto s = sinPolynomial(r, r2);
+	const auto c = cosPolynomial(r2);
+
+	const bool swap = (quadrant & 1) != 0;
+	const auto sineSign = (quadrant & 2) != 0 ? -1.f : 1.f;
+	const auto cosineSign = ((quadrant + 1) & 2) != 0 ? -1.f : 1.f;
+	sine = (swap ? c : s) * sineSign;
+	cosine = (swap ? s : c) * cosineSign;
+}
+
+inline float fastSin(float angle)
+{
+	float sine, cosine;
+	fastSinCos(angle, sine, cosine);
+	return sine;
+}
+
+inline float fastCos(float angle)
+{
+	float sine, cosine;
+	fastSinCos(angle, sine, cosine);
+	return cosine;
+}
+
+// Same range and quadrants as std::atan2, 0 for (0, 0).
+inline float fastAtan2(float y, float x)
+{
+	using namespace FastMathDetail;
+
+	const auto absX = std::fabs(x);
+	const auto absY = std::fabs(y);
+	const auto larger = std::max(absX, absY);
+	const auto smaller = std::min(absX, absY);
+	auto angle = atanPolynomial(larger > 0.f ? smaller / larger : 0.f);
+	angle = absY > absX ? halfPi - angle : angle;
+	angle = x < 0.f ? pi - angle : angle;
+	return y < 0.f ? -angle : angle;
+}
+
+// 1 / sqrt(value) for positive values. Scalar square roots and divisions
+// are only a few cycles and loops over them vectorize, so the inline form
+// stays exact; the array forms refine the hardware estimate instead, which
+// only exists as a SIMD instruction worth using.
+inline float fastRsqrt(float value)
+{
+	return 1.f / std::sqrt(value);
+}
+
+// Array forms, count values each. sines or cosines may be null when only
+// the other is needed. The level overloads force an implementation and are
+// meant for benchmarks; asking for a level above detectKernelLevel() is
+// undefined.
+void fastSinCos(const float* angles, float* sines, float* cosines, std::size_t count);
+void fastSinCos(const float* angles, float* sines, float* cosines, std::size_t count, KernelLevel level);
+void fastAtan2(const float* y, const float* x, float* angles, std::size_t count);
+void fastAtan2(const float* y, const float* x, float* angles, std::size_t count, KernelLevel level);
+void fastRsqrt(const float* values, float* results, std::size_t count);
+void fastRsqrt(const float* values, float* results, std::size_t count, KernelLevel level);
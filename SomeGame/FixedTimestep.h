@@ -0,0 +1,45 @@
+#pragma once
+
+#include <algorithm>
+
+// Turns variable frame times into a whole number of fixed simulation steps.
+// Leftover time carries over to the next frame and doubles as the render
+// interpolation factor. At most MaxStepsPerFrame steps run per frame; time
+// beyond that is dropped, so one long frame slows the game down for a moment
+// instead of making every following frame longer (the death spiral).
+class FixedTimestep
+{
+public:
+	FixedTimestep(float stepSeconds, int maxStepsPerFrame)
+		: StepSeconds(stepSeconds), MaxStepsPerFrame(maxStepsPerFrame)
+	{
+	}
+
+	// Returns how many steps to simulate for a frame that took frameSeconds.
+	int advance(float frameSeconds)
+	{
+		Accumulator += frameSeconds;
+
+		int steps = 0;
+		while (Accumulator >= StepSeconds && steps < MaxStepsPerFrame)
+		{
+			Accumulator -= StepSeconds;
+			steps++;
+		}
+
+		if (steps == MaxStepsPerFrame)
+			Accumulator = std::min(Accumulator, StepSeconds);
+
+		return steps;
+	}
+
+	float getStepSeconds() const { return StepSeconds; }
+
+	// How far the renderer is between the last two steps, in [0, 1].
+	float getInterpolation() const { return std::clamp(Accumulator / StepSeconds, 0.f, 1.f); }
+
+private:
+	float StepSeconds{};
+	int MaxStepsPerFrame{};
+	float Accumulator{};
+};
@@ -0,0 +1,69 @@
+#include "FrameTimeGraph.h"
+
+#include <algorithm>
+
+#include <SFML/Graphics/RenderTarget.hpp>
+
+namespace
+{
+	constexpr float budgetMilliseconds = 1000.f / 60.f;
+}
+
+FrameTimeGraph::FrameTimeGraph(sf::FloatRect area, float maxMilliseconds)
+	: Area(area), MaxMilliseconds(maxMilliseconds)
+{
+}
+
+void FrameTimeGraph::update(const FrameTimings& timings)
+{
+	// Background, budget line and one bar per frame.
+	const auto required = (timings.capacity() + 2) * 6;
+	if (Vertices.getVertexCount() < required)
+		Vertices.resize(required);
+	VertexCount = 0;
+
+	appendQuad(Area.position, Area.size, sf::Color{ 0, 0, 0, 160 });
+
+	const auto barWidth = Area.size.x / static_cast<float>(timings.capacity());
+	const auto bottom = Area.position.y + Area.size.y;
+	// Bars fill in from the right while the buffer is still filling up.
+	auto left = Area.position.x + Area.size.x - barWidth * static_cast<float>(timings.size());
+	for (std::size_t i = 0; i < timings.size(); i++, left += barWidth)
+	{
+		const auto milliseconds = timings[i].FrameMilliseconds;
+		const auto height = std::min(milliseconds / MaxMilliseconds, 1.f) * Area.size.y;
+		const auto color = milliseconds <= budgetMilliseconds ? sf::Color::Green
+			: milliseconds <= budgetMilliseconds * 2 ? sf::Color::Yellow
+			: sf::Color::Red;
+		appendQuad({ left, bottom - height }, { barWidth, height }, color);
+	}
+
+	const auto budgetY = bottom - budgetMilliseconds / MaxMilliseconds * Area.size.y;
+	appendQuad({ Area.position.x, budgetY }, { Area.size.x, 1.f }, sf::Color::White);
+}
+
+void FrameTimeGraph::appendQuad(sf::Vector2f topLeft, sf::Vector2f size, sf::Color color)
+{
+	const sf::Vector2f corners[4]
+	{
+		topLeft,
+		{ topLeft.x + size.x, topLeft.y },
+		topLeft + size,
+		{ topLeft.x, topLeft.y + size.y },
+	};
+
+	for (const auto corner : { 0, 1, 2, 0, 2, 3 })
+	{
+		auto& vertex = Vertices[VertexCount++];
+		vertex.position = corners[corner];
+		vertex.color = color;
+	}
+}
+
+void FrameTimeGraph::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	if (VertexCount == 0)
+		return;
+
+	target.draw(&Vertices[0], VertexCount, sf::PrimitiveType::Triangles, states);
+}
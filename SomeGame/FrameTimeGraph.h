@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+#include "FrameTimings.h"
+
+// Bar graph of the frame times in a FrameTimings, newest on the right, with
+// a line at the 60 fps budget. Background, bars and line are one vertex
+// array and one draw call. Bars are clipped at maxMilliseconds.
+class FrameTimeGraph : public sf::Drawable
+{
+public:
+	FrameTimeGraph(sf::FloatRect area, float maxMilliseconds);
+
+	void update(const FrameTimings& timings);
+
+private:
+	sf::VertexArray Vertices{ sf::PrimitiveType::Triangles };
+	std::size_t VertexCount{};
+	sf::FloatRect Area;
+	float MaxMilliseconds{};
+
+	void appendQuad(sf::Vector2f topLeft, sf::Vector2f size, sf::Color color);
+	void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+};
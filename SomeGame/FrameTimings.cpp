@@ -0,0 +1,174 @@
+#include "FrameTimings.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+
+namespace
+{
+	constexpr std::array<FramePhase, framePhaseCount> framePhases
+	{
+		FramePhase::Input,
+		FramePhase::Simulation,
+		FramePhase::Extract,
+		FramePhase::Wait,
+	};
+
+	// Nearest-rank percentile of a sorted, non-empty range.
+	float getPercentile(const std::vector<float>& sorted, float percentile)
+	{
+		const auto rank = static_cast<std::size_t>(std::ceil(percentile / 100.f * static_cast<float>(sorted.size())));
+		return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+	}
+
+	void writeStatisticsJson(std::ofstream& file, const TimingStatistics& statistics)
+	{
+		file << "{ \"avg\": " << statistics.Average
+			<< ", \"p50\": " << statistics.P50
+			<< ", \"p95\": " << statistics.P95
+			<< ", \"p99\": " << statistics.P99
+			<< ", \"max\": " << statistics.Max << " }";
+	}
+}
+
+const char* toString(FramePhase phase)
+{
+	switch (phase)
+	{
+	case FramePhase::Input: return "input";
+	case FramePhase::Simulation: return "simulation";
+	case FramePhase::Extract: return "extract";
+	case FramePhase::Wait: return "wait";
+	}
+	return "unknown";
+}
+
+FrameTimings::FrameTimings(std::size_t capacity)
+	: Samples(std::max<std::size_t>(capacity, 1))
+{
+	Scratch.reserve(Samples.size());
+}
+
+void FrameTimings::record(FramePhase phase, float seconds)
+{
+	Current.PhaseMilliseconds[static_cast<std::size_t>(phase)] += seconds * 1000.f;
+}
+
+void FrameTimings::endFrame(float frameSeconds)
+{
+	Current.FrameMilliseconds = frameSeconds * 1000.f;
+	Samples[Next] = Current;
+	Current = {};
+
+	Next = (Next + 1) % Samples.size();
+	Count = std::min(Count + 1, Samples.size());
+}
+
+const FrameSample& FrameTimings::operator[](std::size_t index) const
+{
+	assert(index < Count);
+	return Samples[(Next + Samples.size() - Count + index) % Samples.size()];
+}
+
+template <typename Select>
+TimingStatistics FrameTimings::getStatistics(Select&& select) const
+{
+	if (Count == 0)
+		return {};
+
+	Scratch.clear();
+	for (std::size_t i = 0; i < Count; i++)
+		Scratch.push_back(select((*this)[i]));
+	std::sort(Scratch.begin(), Scratch.end());
+
+	return {
+		std::accumulate(Scratch.begin(), Scratch.end(), 0.f) / static_cast<float>(Count),
+		getPercentile(Scratch, 50.f),
+		getPercentile(Scratch, 95.f),
+		getPercentile(Scratch, 99.f),
+		Scratch.back()
+	};
+}
+
+FrameStatistics FrameTimings::getStatistics() const
+{
+	FrameStatistics statistics{};
+	statistics.Samples = Count;
+	statistics.Frame = getStatistics([](const FrameSample& sample) { return sample.FrameMilliseconds; });
+	for (std::size_t phase = 0; phase < framePhaseCount; phase++)
+		statistics.Phases[phase] = getStatistics([&](const FrameSample& sample) { return sample.PhaseMilliseconds[phase]; });
+	return statistics;
+}
+
+bool FrameTimings::exportCsv(const std::string& path) const
+{
+	std::ofstream file{ path };
+	if (!file)
+		return false;
+
+	file << "frame_ms";
+	for (const auto phase : framePhases)
+		file << "," << toString(phase) << "_ms";
+	file << "\n";
+
+	for (std::size_t i = 0; i < Count; i++)
+	{
+		const auto& sample = (*this)[i];
+		file << sample.FrameMilliseconds;
+		for (const auto milliseconds : sample.PhaseMilliseconds)
+			file << "," << milliseconds;
+		file << "\n";
+	}
+
+	return static_cast<bool>(file);
+}
+
+bool FrameTimings::exportJson(const std::string& path) const
+{
+	std::ofstream file{ path };
+	if (!file)
+		return false;
+
+	const auto statistics = getStatistics();
+	file << "{\n  \"statistics\": {\n    \"frame\": ";
+	writeStatisticsJson(file, statistics.Frame);
+	for (const auto phase : framePhases)
+	{
+		file << ",\n    \"" << toString(phase) << "\": ";
+		writeStatisticsJson(file, statistics.Phases[static_cast<std::size_t>(phase)]);
+	}
+
+	file << "\n  },\n  \"frames\": [";
+	for (std::size_t i = 0; i < Count; i++)
+	{
+		const auto& sample = (*this)[i];
+		file << (i == 0 ? "\n    " : ",\n    ") << "{ \"frame\": " << sample.FrameMilliseconds;
+		for (const auto phase : framePhases)
+			file << ", \"" << toString(phase) << "\": " << sample.PhaseMilliseconds[static_cast<std::size_t>(phase)];
+		file << " }";
+	}
+	file << "\n  ]\n}\n";
+
+	return static_cast<bool>(file);
+}
+
+std::string formatStatistics(const FrameStatistics& statistics)
+{
+	const auto formatLine = [](const char* name, const TimingStatistics& timing)
+	{
+		char line[128];
+		std::snprintf(line, sizeof(line), "%-10s avg %6.2f  p50 %6.2f  p95 %6.2f  p99 %6.2f  max %6.2f\n",
+			name, timing.Average, timing.P50, timing.P95, timing.P99, timing.Max);
+		return std::string{ line };
+	};
+
+	const auto fps = statistics.Frame.Average > 0.f ? 1000.f / statistics.Frame.Average : 0.f;
+	std::string text = "FPS: " + std::to_string(static_cast<int>(fps)) + "  (ms over " + std::to_string(statistics.Samples) + " frames)\n";
+	text += formatLine("frame", statistics.Frame);
+	for (const auto phase : framePhases)
+		text += formatLine(toString(phase), statistics.Phases[static_cast<std::size_t>(phase)]);
+	return text;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Parts of a frame on the main thread that are timed separately.
+enum class FramePhase
+{
+	Input,      // events and input polling
+	Simulation, // every fixed step of the frame
+	Extract,    // filling the render snapshot
+	Wait,       // waiting for the render thread to take the last snapshot
+};
+
+constexpr std::size_t framePhaseCount = 4;
+
+const char* toString(FramePhase phase);
+
+struct FrameSample
+{
+	float FrameMilliseconds{};
+	std::array<float, framePhaseCount> PhaseMilliseconds{};
+};
+
+struct TimingStatistics
+{
+	float Average{};
+	float P50{};
+	float P95{};
+	float P99{};
+	float Max{};
+};
+
+struct FrameStatistics
+{
+	std::size_t Samples{};
+	TimingStatistics Frame{};
+	std::array<TimingStatistics, framePhaseCount> Phases{};
+};
+
+// Keeps the times of the last capacity frames in a ring buffer, so the
+// statistics show stutter that a single frame's 1/dt hides.
+// Phases are recorded while a frame runs and endFrame() stores the frame.
+class FrameTimings
+{
+public:
+	explicit FrameTimings(std::size_t capacity = 600);
+
+	void record(FramePhase phase, float seconds);
+	void endFrame(float frameSeconds);
+
+	FrameStatistics getStatistics() const;
+
+	// Oldest first.
+	const FrameSample& operator[](std::size_t index) const;
+	std::size_t size() const { return Count; }
+	std::size_t capacity() const { return Samples.size(); }
+
+	// One row per frame, oldest first. Return false when the file can't be written.
+	bool exportCsv(const std::string& path) const;
+	// The frames plus the statistics.
+	bool exportJson(const std::string& path) const;
+
+private:
+	std::vector<FrameSample> Samples;
+	std::size_t Next{};
+	std::size_t Count{};
+	FrameSample Current{};
+	mutable std::vector<float> Scratch; // sorted copy for percentiles
+
+	template <typename Select>
+	TimingStatistics getStatistics(Select&& select) const;
+};
+
+// Formats the statistics as the lines of the overlay.
+std::string formatStatistics(const FrameStatistics& statistics);
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+
+#include <SFML/System/Vector2.hpp>
+
+#include "Projectile.h"
+
+constexpr int windowWidth = 800;
+constexpr int windowHeight = 600;
+const sf::Vector2f windowSize
+{
+	static_cast<float>(windowWidth),
+	static_cast<float>(windowHeight)
+};
+
+constexpr float simulationRate = 120.f; // steps per second
+constexpr int maxSimulationStepsPerFrame = 8;
+
+constexpr float playerRadius = 50.f;
+constexpr float playerSpeed = 200.f;
+constexpr float projectileSpeed = 1000.f;
+constexpr float projectileRadius = 5.f;
+constexpr float projectileFireInterval = 0.1f; // seconds between shots
+constexpr TargetMode projectileTargetMode = TargetMode::StopAtTarget;
+constexpr float projectileLifetime = 10.f; // seconds before a projectile that hit nothing is removed
+constexpr std::size_t maxProjectiles = 1 << 16; // per movement model
+constexpr std::size_t maxEnemyProjectiles = 1 << 17;
+
+constexpr float enemyRadius = 15.f;
+constexpr float enemySpeed = 300.f;
+constexpr int enemyHp = 100;
+constexpr std::size_t maxEnemies = 4096;
+
+enum class CollisionMode
+{
+	Discrete,   // overlap at the end of each step, fast projectiles can skip over small enemies
+	Continuous, // swept circles with time of impact, hits don't depend on the tick rate
+};
+
+constexpr float collisionCellSize = 64.f;
+constexpr CollisionMode projectileCollisionMode = CollisionMode::Continuous;
+
+constexpr float hitchBudgetMilliseconds = 50.f; // longer frames count as hitches, --hitch-budget overrides it
+constexpr float hitchHistorySeconds = 3.f; // how far back a hitch dump goes
+constexpr float hitchCooldownSeconds = 5.f; // at most one dump this often
+
+constexpr std::size_t parallelChunkSize = 1024; // entities, projectiles or circles per job when work is split across threads
@@ -0,0 +1,498 @@
+#include "Headless.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "AllocationCounter.h"
+#include "BulletPattern.h"
+#include "FrameTimings.h"
+#include "HitchDetector.h"
+#include "InputRecording.h"
+#include "Log.h"
+#include "PerfCounters.h"
+#include "Simulation.h"
+#include "Trace.h"
+
+namespace
+{
+	struct HeadlessOptions
+	{
+		std::size_t Ticks = 3600;
+		Scenario Setup{};
+		// Whether --enemies, --waves or --collision was given.
+		bool SetupGiven = false;
+		float Rate = simulationRate;
+		std::string ScriptPath{};
+		std::size_t Threads = std::max(1u, std::thread::hardware_concurrency());
+		bool ThreadScaling = false;
+		bool CheckAllocations = false;
+		std::string TimingsPath{};
+		std::string TracePath{};
+		std::optional<float> HitchBudget{};
+		std::string RecordPath{};
+		std::string ReplayPath{};
+		std::optional<InputRecording> Replay{};
+		// Bullet pattern names, empty for none.
+		std::string PlayerPattern{};
+		std::string EnemyPattern{};
+	};
+
+	struct HeadlessResult
+	{
+		std::chrono::duration<double, std::micro> Total{};
+		std::chrono::duration<double, std::micro> Slowest{};
+		SimulationStats Stats{};
+		std::size_t EnemiesLeft{};
+		std::size_t LiveProjectiles{};
+		std::size_t LiveEnemyProjectiles{};
+		std::size_t PeakEnemyProjectiles{};
+		FrameStatistics StepStatistics{};
+		std::size_t Hitches{};
+		std::uint64_t SteadyAllocations{};
+		PerfTotals Perf{};
+		std::uint64_t Checksum{};
+	};
+
+	std::vector<InputSegment> defaultScript()
+	{
+		InputState strafeRight{};
+		strafeRight.MoveRight = true;
+		strafeRight.Fire = true;
+		strafeRight.AimPosition = { 400.f, 400.f };
+
+		InputState strafeLeft = strafeRight;
+		strafeLeft.MoveRight = false;
+		strafeLeft.MoveLeft = true;
+
+		return { { 120, strafeRight }, { 120, strafeLeft } };
+	}
+
+	bool parseScript(std::istream& stream, std::vector<InputSegment>& script)
+	{
+		std::string line;
+		for (std::size_t lineNumber = 1; std::getline(stream, line); lineNumber++)
+		{
+			if (line.empty() || line.front() == '#')
+				continue;
+
+			std::istringstream fields{ line };
+			InputSegment segment{};
+			std::string keys;
+			if (!(fields >> segment.Ticks >> keys >> segment.Input.AimPosition.x >> segment.Input.AimPosition.y))
+			{
+				std::cerr << "Input script line " << lineNumber << ": expected 'ticks keys aimX aimY [movement]'\n";
+				return false;
+			}
+
+			std::size_t movement{};
+			if (fields >> movement && movement > 0)
+				segment.Input.SelectMovement = movement - 1;
+
+			for (const auto key : keys)
+			{
+				switch (key)
+				{
+				case 'W': segment.Input.MoveUp = true; break;
+				case 'A': segment.Input.MoveLeft = true; break;
+				case 'S': segment.Input.MoveDown = true; break;
+				case 'D': segment.Input.MoveRight = true; break;
+				case 'F': segment.Input.Fire = true; break;
+				case '-': break;
+				default:
+					std::cerr << "Input script line " << lineNumber << ": unknown key '" << key << "'\n";
+					return false;
+				}
+			}
+
+			script.push_back(segment);
+		}
+
+		return true;
+	}
+
+	// Spreads enemies over the window in rows, appending their handles to spawned.
+	void spawnEnemyLattice(Simulation& simulation, std::size_t enemies, std::vector<Entity>& spawned)
+	{
+		if (enemies == 0)
+			return;
+
+		const auto columns = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(enemies))));
+		const auto rows = (enemies + columns - 1) / columns;
+		const sf::Vector2f spacing
+		{
+			(windowSize.x - 100.f) / static_cast<float>(columns),
+			(windowSize.y - 200.f) / static_cast<float>(rows)
+		};
+
+		for (std::size_t i = 0; i < enemies; i++)
+		{
+			const auto handle = simulation.spawnEnemy({
+				50.f + spacing.x * static_cast<float>(i % columns),
+				100.f + spacing.y * static_cast<float>(i / columns) });
+			if (handle)
+				spawned.push_back(*handle);
+		}
+	}
+
+	bool parseOptions(int argc, char* argv[], HeadlessOptions& options)
+	{
+		for (int i = 2; i < argc; i++)
+		{
+			const std::string_view argument{ argv[i] };
+			if (argument == "--thread-scaling")
+			{
+				options.ThreadScaling = true;
+				continue;
+			}
+			if (argument == "--check-allocations")
+			{
+				options.CheckAllocations = true;
+				continue;
+			}
+
+			if (i + 1 >= argc)
+			{
+				std::cerr << "Missing value for " << argument << "\n";
+				return false;
+			}
+
+			if (argument == "--enemies" || argument == "--waves" || argument == "--collision")
+				options.SetupGiven = true;
+
+			if (argument == "--ticks")
+				options.Ticks = std::stoul(argv[++i]);
+			else if (argument == "--enemies")
+				options.Setup.Enemies = std::stoul(argv[++i]);
+			else if (argument == "--waves")
+				options.Setup.WaveSize = std::stoul(argv[++i]);
+			else if (argument == "--collision")
+			{
+				const std::string_view mode{ argv[++i] };
+				if (mode == "discrete")
+					options.Setup.Collision = CollisionMode::Discrete;
+				else if (mode == "continuous")
+					options.Setup.Collision = CollisionMode::Continuous;
+				else
+				{
+					std::cerr << "--collision has to be discrete or continuous\n";
+					return false;
+				}
+			}
+			else if (argument == "--rate")
+				options.Rate = std::stof(argv[++i]);
+			else if (argument == "--script")
+				options.ScriptPath = argv[++i];
+			else if (argument == "--threads")
+				options.Threads = std::stoul(argv[++i]);
+			else if (argument == "--export-timings")
+				options.TimingsPath = argv[++i];
+			else if (argument == "--trace")
+				options.TracePath = argv[++i];
+			else if (argument == "--hitch-budget")
+				options.HitchBudget = std::stof(argv[++i]);
+			else if (argument == "--record")
+				options.RecordPath = argv[++i];
+			else if (argument == "--replay")
+				options.ReplayPath = argv[++i];
+			else if (argument == "--pattern" || argument == "--player-pattern")
+			{
+				if (!findBulletPattern(argv[++i]))
+				{
+					std::cerr << argument << " has to be radial, spiral, fan or burst\n";
+					return false;
+				}
+				(argument == "--pattern" ? options.EnemyPattern : options.PlayerPattern) = argv[i];
+			}
+			else
+			{
+				std::cerr << "Unknown option " << argument << "\n";
+				return false;
+			}
+		}
+
+		if (options.Rate <= 0.f)
+		{
+			std::cerr << "--rate has to be positive\n";
+			return false;
+		}
+
+		if (options.Threads == 0)
+		{
+			std::cerr << "--threads has to be at least 1\n";
+			return false;
+		}
+
+		return true;
+	}
+
+	HeadlessResult runScenario(const HeadlessOptions& options, const std::vector<InputSegment>& script, std::size_t threads)
+	{
+		JobSystem jobs{ threads };
+		Simulation simulation{ jobs };
+		simulation.ProjectileCollision = options.Setup.Collision;
+		if (!options.PlayerPattern.empty())
+			simulation.PlayerPattern.emplace(*findBulletPattern(options.PlayerPattern));
+		if (!options.EnemyPattern.empty())
+			simulation.EnemyPattern.emplace(*findBulletPattern(options.EnemyPattern));
+		// A replay has to step exactly as long as the recorded steps.
+		const auto deltaSeconds = options.Replay ? options.Replay->StepSeconds : 1.f / options.Rate;
+
+		InputRecording recording{};
+		recording.StepSeconds = deltaSeconds;
+		recording.EnemyPattern = options.EnemyPattern;
+		recording.PlayerPattern = options.PlayerPattern;
+		recording.Setup = options.Setup;
+
+		// The simulation starts with one enemy.
+		std::vector<Entity> standing;
+		spawnEnemyLattice(simulation, options.Setup.Enemies > 1 ? options.Setup.Enemies - 1 : 0, standing);
+
+		std::vector<Entity> wave;
+		wave.reserve(options.Setup.WaveSize);
+
+		// Rounded: a replay's rate comes back from its step length as 119.99... Hz.
+		const auto ticksPerWave = std::max<std::size_t>(static_cast<std::size_t>(std::lround(options.Rate)), 1);
+
+		using Clock = std::chrono::steady_clock;
+		HeadlessResult result{};
+		// Every step is one frame here, all of it simulation.
+		FrameTimings timings{ options.Ticks };
+		std::optional<HitchDetector> hitchDetector;
+		if (options.HitchBudget)
+			hitchDetector.emplace(*options.HitchBudget, hitchHistorySeconds, hitchCooldownSeconds);
+
+		takePerfTotals();
+
+		std::size_t segment = 0;
+		std::size_t ticksInSegment = 0;
+		for (std::size_t tick = 0; tick < options.Ticks; tick++)
+		{
+			if (ticksInSegment >= script[segment].Ticks)
+			{
+				segment = (segment + 1) % script.size();
+				ticksInSegment = 0;
+			}
+			ticksInSegment++;
+
+			const auto start = Clock::now();
+			// Every simulated second, whatever is left of the last wave despawns and a new one spawns.
+			if (options.Setup.WaveSize > 0 && tick % ticksPerWave == 0)
+			{
+				for (const auto handle : wave)
+					simulation.Enemies.despawn(handle);
+				wave.clear();
+				spawnEnemyLattice(simulation, options.Setup.WaveSize, wave);
+			}
+
+			const auto allocationsBefore = getAllocationCount();
+			simulation.step(deltaSeconds, script[segment].Input);
+			const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+			// The first second warms up thread-local buffers and the like.
+			if (tick >= ticksPerWave)
+				result.SteadyAllocations += getAllocationCount() - allocationsBefore;
+
+			if (!options.RecordPath.empty())
+				recording.record(script[segment].Input);
+			result.PeakEnemyProjectiles = std::max(result.PeakEnemyProjectiles, simulation.EnemyProjectiles.Projectiles.size());
+
+			result.Total += elapsed;
+			result.Slowest = std::max(result.Slowest, elapsed);
+			timings.record(FramePhase::Simulation, static_cast<float>(elapsed.count() / 1e6));
+			timings.endFrame(static_cast<float>(elapsed.count() / 1e6));
+
+			if (hitchDetector)
+			{
+				const auto hitchPath = hitchDetector->recordFrame(timings[timings.size() - 1], simulation.Enemies.size(), simulation.getProjectileCount());
+				if (hitchPath)
+					std::cout << "Step " << tick << " took " << elapsed.count() << " us, saving " << *hitchPath << "\n";
+			}
+		}
+
+		if (hitchDetector)
+			result.Hitches = hitchDetector->getHitchCount();
+
+		result.Checksum = simulation.computeChecksum();
+		if (!options.RecordPath.empty())
+		{
+			recording.FinalChecksum = result.Checksum;
+			if (recording.save(options.RecordPath))
+				std::cout << "Saved input recording to " << options.RecordPath << "\n";
+			else
+				std::cerr << "Can't write input recording to " << options.RecordPath << "\n";
+		}
+
+		result.Perf = takePerfTotals();
+		result.StepStatistics = timings.getStatistics();
+		if (!options.TimingsPath.empty())
+		{
+			const auto json = options.TimingsPath.ends_with(".json");
+			if (json ? timings.exportJson(options.TimingsPath) : timings.exportCsv(options.TimingsPath))
+				std::cout << "Saved step timings to " << options.TimingsPath << "\n";
+			else
+				std::cerr << "Can't write step timings to " << options.TimingsPath << "\n";
+		}
+
+		result.Stats = simulation.Stats;
+		result.EnemiesLeft = simulation.Enemies.size();
+		result.LiveProjectiles = simulation.Projectiles.size();
+		result.LiveEnemyProjectiles = simulation.EnemyProjectiles.Projectiles.size();
+		return result;
+	}
+}
+
+int runHeadless(int argc, char* argv[])
+{
+	HeadlessOptions options{};
+	try
+	{
+		if (!parseOptions(argc, argv, options))
+			return 1;
+	}
+	catch (const std::exception&)
+	{
+		std::cerr << "Invalid number in headless options\n";
+		return 1;
+	}
+
+	std::vector<InputSegment> script;
+	if (!options.ReplayPath.empty())
+	{
+		options.Replay = InputRecording::load(options.ReplayPath);
+		if (!options.Replay)
+		{
+			std::cerr << "Can't read input recording " << options.ReplayPath << "\n";
+			return 1;
+		}
+
+		// The recording replaces the script and decides how long the run is.
+		script = options.Replay->Segments;
+		options.Ticks = static_cast<std::size_t>(options.Replay->Ticks);
+		options.Rate = 1.f / options.Replay->StepSeconds;
+		if (const auto error = adoptRecordedPatterns(*options.Replay, options.EnemyPattern, options.PlayerPattern))
+		{
+			std::cerr << *error << "\n";
+			return 1;
+		}
+		if (const auto error = adoptRecordedScenario(*options.Replay, options.Setup, options.SetupGiven))
+		{
+			std::cerr << *error << "\n";
+			return 1;
+		}
+		if (options.Replay->Kernel != detectKernelLevel())
+			std::cerr << "Recorded with " << toString(options.Replay->Kernel) << " kernels, replaying with "
+				<< toString(detectKernelLevel()) << ", the state may drift\n";
+	}
+	else if (options.ScriptPath.empty())
+	{
+		script = defaultScript();
+	}
+	else
+	{
+		std::ifstream file{ options.ScriptPath };
+		if (!file)
+		{
+			std::cerr << "Can't open input script " << options.ScriptPath << "\n";
+			return 1;
+		}
+		if (!parseScript(file, script))
+			return 1;
+	}
+	if (script.empty())
+		script.push_back({});
+
+	if (options.ThreadScaling)
+	{
+		// Same run at 1, 2, 4... threads up to --threads, to see how the step scales.
+		std::cout << "Headless thread scaling: " << options.Ticks << " ticks at " << options.Rate << " Hz\n";
+		std::cout << std::left << std::setw(10) << "threads"
+			<< std::setw(14) << "avg step us"
+			<< std::setw(14) << "max step us"
+			<< "speedup\n";
+
+		std::vector<std::size_t> threadCounts;
+		for (std::size_t threads = 1; threads < options.Threads; threads *= 2)
+			threadCounts.push_back(threads);
+		threadCounts.push_back(options.Threads);
+
+		const auto ticks = static_cast<double>(std::max<std::size_t>(options.Ticks, 1));
+		double baseline{};
+		for (const auto threads : threadCounts)
+		{
+			const auto result = runScenario(options, script, threads);
+			flushLog();
+			const auto average = result.Total.count() / ticks;
+			if (threads == 1)
+				baseline = average;
+
+			std::cout << std::left << std::fixed << std::setprecision(2)
+				<< std::setw(10) << threads
+				<< std::setw(14) << average
+				<< std::setw(14) << result.Slowest.count()
+				<< baseline / average << "x\n";
+		}
+		return 0;
+	}
+
+	setTraceThreadName("main");
+	const auto result = runScenario(options, script, options.Threads);
+	// Debug builds log every hit; keep that out of the middle of the report.
+	flushLog();
+	if (!options.TracePath.empty())
+	{
+		if (writeChromeTrace(options.TracePath))
+			std::cout << "Saved trace to " << options.TracePath << "\n";
+		else
+			std::cerr << "Can't write trace to " << options.TracePath << " (tracing may be compiled out)\n";
+	}
+	const auto deltaSeconds = 1.f / options.Rate;
+
+	const auto ticks = std::max<std::size_t>(options.Ticks, 1);
+	std::cout << std::fixed << std::setprecision(2)
+		<< "Headless run: " << options.Ticks << " ticks at " << options.Rate << " Hz ("
+		<< static_cast<double>(options.Ticks) * deltaSeconds << " s simulated, " << options.Threads << " threads)\n"
+		<< "  total step time: " << result.Total.count() / 1000.0 << " ms\n"
+		<< "  avg step: " << result.Total.count() / static_cast<double>(ticks) << " us, max step: " << result.Slowest.count() << " us\n"
+		<< "  step p50: " << result.StepStatistics.Frame.P50 * 1000.f
+		<< " us, p95: " << result.StepStatistics.Frame.P95 * 1000.f
+		<< " us, p99: " << result.StepStatistics.Frame.P99 * 1000.f << " us\n"
+		<< "  projectiles fired: " << result.Stats.ProjectilesFired
+		<< ", enemy hits: " << result.Stats.EnemyHits
+		<< ", enemies left: " << result.EnemiesLeft
+		<< ", live projectiles: " << result.LiveProjectiles << "\n";
+	if (!options.EnemyPattern.empty())
+		std::cout << "  enemy projectiles fired: " << result.Stats.EnemyProjectilesFired
+			<< ", live: " << result.LiveEnemyProjectiles << ", peak live: " << result.PeakEnemyProjectiles << "\n";
+	std::cout << "  heap allocations in steps after the first second: " << result.SteadyAllocations << "\n";
+	if (options.HitchBudget)
+		std::cout << "  steps over " << *options.HitchBudget << " ms: " << result.Hitches << "\n";
+	std::cout << "  state checksum: " << std::hex << result.Checksum << std::dec << "\n";
+	if (options.Replay)
+	{
+		std::cout << (result.Checksum == options.Replay->FinalChecksum
+			? "  replay ended in the recorded state\n"
+			: "  replay ended in a different state than recorded (different build or kernels?)\n");
+	}
+	if (arePerfCountersAvailable())
+		std::cout << "  hardware counters per step:\n" << formatPerfTotals(result.Perf, options.Ticks);
+
+	// Steady-state steps must not touch the heap, however many threads run them.
+	if (options.CheckAllocations && result.SteadyAllocations > 0)
+	{
+		std::cerr << "Steps allocated " << result.SteadyAllocations << " times after warming up\n";
+		return 1;
+	}
+
+	return 0;
+}
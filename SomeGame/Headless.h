@@ -0,0 +1,39 @@
+#pragma once
+
+// Runs the simulation without a window and reports how long it took:
+//	SomeGame --headless [--ticks N] [--rate HZ] [--enemies N] [--waves N]
+//		[--collision discrete|continuous] [--script FILE]
+//		[--threads N] [--thread-scaling] [--export-timings FILE] [--trace FILE]
+//		[--hitch-budget MS] [--record FILE] [--replay FILE]
+//		[--pattern NAME] [--player-pattern NAME]
+// Steps are fixed at 1/rate seconds and run back to back, not in real time.
+// --threads sets how many threads the job system uses, all cores by default;
+// --thread-scaling repeats the run at 1, 2, 4... threads up to that count
+// and compares the average step times. --export-timings saves every step's
+// time as CSV, or as JSON when FILE ends in .json, to compare builds.
+// --trace saves the trace zones of the last steps as Chrome trace JSON.
+// --hitch-budget treats steps longer than MS like hitched frames and saves
+// the steps and trace zones leading up to them.
+// --enemies spreads that many enemies over the window for load testing,
+// --waves despawns the previous wave and spawns N new enemies every
+// simulated second.
+//
+// An input script holds one segment per line, played in order and looped
+// until the run is over:
+//	# ticks keys aimX aimY [movement]
+//	120 D 400 400
+//	300 WF 400 300 2
+// keys is any of W, A, S, D and F (fire), or - for none. movement picks the
+// projectile movement model like the number keys do, starting at 1.
+// Without a script the player strafes and fires at the enemy's lane.
+//
+// --pattern makes every enemy fire a bullet pattern at the player, and
+// --player-pattern has the player fire one instead of single shots; NAME is
+// radial, spiral, fan or burst. Many enemies with a dense pattern make a
+// stress test with tens of thousands of live projectiles.
+//
+// --record saves the input of every step as a binary input recording, and
+// --replay plays one back instead of a script, from the game or a headless
+// run, for as many steps as were recorded. The run then reports whether it
+// ended in exactly the recorded state.
+int runHeadless(int argc, char* argv[]);
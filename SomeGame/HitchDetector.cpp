@@ -0,0 +1,126 @@
+#include "HitchDetector.h"
+
+#include <fstream>
+
+#include "AllocationCounter.h"
+#include "Log.h"
+#include "Trace.h"
+
+namespace
+{
+	// Enough for a few seconds even at very high frame rates; older frames
+	// than the history are left out when saving anyway.
+	constexpr std::size_t maxFrames = 4096;
+}
+
+HitchDetector::HitchDetector(float budgetMilliseconds, float historySeconds, float cooldownSeconds)
+	: BudgetMilliseconds(budgetMilliseconds),
+	History(historySeconds),
+	Cooldown(cooldownSeconds),
+	Frames(maxFrames),
+	LastAllocations(getAllocationCount()),
+	LastAllocatedBytes(getAllocatedBytes())
+{
+	SavedFrames.reserve(maxFrames);
+}
+
+std::optional<std::string> HitchDetector::recordFrame(const FrameSample& timing, std::size_t enemies, std::size_t projectiles)
+{
+	const auto allocations = getAllocationCount();
+	const auto allocatedBytes = getAllocatedBytes();
+
+	auto& frame = Frames[Next];
+	frame.Index = FrameIndex++;
+	frame.End = std::chrono::steady_clock::now();
+	frame.Timing = timing;
+	frame.Enemies = enemies;
+	frame.Projectiles = projectiles;
+	frame.Allocations = allocations - LastAllocations;
+	frame.AllocatedBytes = allocatedBytes - LastAllocatedBytes;
+	LastAllocations = allocations;
+	LastAllocatedBytes = allocatedBytes;
+
+	Next = (Next + 1) % Frames.size();
+	Count = std::min(Count + 1, Frames.size());
+
+	if (timing.FrameMilliseconds <= BudgetMilliseconds)
+		return std::nullopt;
+
+	HitchCount++;
+	if (LastSaved && frame.End - *LastSaved < Cooldown)
+		return std::nullopt;
+	if (Writing.load(std::memory_order_acquire))
+		return std::nullopt;
+	LastSaved = frame.End;
+
+	// Oldest frame still within the history.
+	std::size_t oldest = 0;
+	while (oldest + 1 < Count && frame.End - getFrame(oldest + 1).End <= History)
+		oldest++;
+
+	SavedFrames.clear();
+	for (auto age = oldest + 1; age-- > 0;)
+		SavedFrames.push_back(getFrame(age));
+
+	// Zones are on the trace clock, so go back the same amount of time from now.
+	const auto historyNanoseconds = static_cast<std::uint64_t>(History.count() * 1e9f);
+	const auto now = getTraceTimestamp();
+
+	auto path = "hitch_" + std::to_string(SavedCount++);
+	Writing.store(true, std::memory_order_relaxed);
+	Writer = std::jthread([this, path, hitch = frame, since = now > historyNanoseconds ? now - historyNanoseconds : 0]
+	{
+		write(path, hitch, since);
+	});
+
+	return path + ".json";
+}
+
+void HitchDetector::write(std::string path, HitchFrame hitch, std::uint64_t traceSince)
+{
+	setTraceThreadName("hitch writer");
+	if (!save(path + ".json", hitch))
+		LOG_ERROR("Can't write {}.json", path);
+	else if (!writeChromeTrace(path + "_trace.json", traceSince))
+		LOG_ERROR("Can't write {}_trace.json", path);
+
+	Writing.store(false, std::memory_order_release);
+}
+
+const HitchFrame& HitchDetector::getFrame(std::size_t age) const
+{
+	return Frames[(Next + Frames.size() - 1 - age) % Frames.size()];
+}
+
+bool HitchDetector::save(const std::string& path, const HitchFrame& hitch) const
+{
+	std::ofstream file{ path };
+	if (!file)
+		return false;
+
+	file << "{\n  \"budget_ms\": " << BudgetMilliseconds
+		<< ",\n  \"hitch_frame\": " << hitch.Index
+		<< ",\n  \"hitch_ms\": " << hitch.Timing.FrameMilliseconds
+		<< ",\n  \"frames\": [";
+
+	for (std::size_t i = 0; i < SavedFrames.size(); i++)
+	{
+		const auto& frame = SavedFrames[i];
+		const std::chrono::duration<float> beforeHitch = hitch.End - frame.End;
+
+		file << (i == 0 ? "\n    " : ",\n    ")
+			<< "{ \"frame\": " << frame.Index
+			<< ", \"seconds_before_hitch\": " << beforeHitch.count()
+			<< ", \"frame_ms\": " << frame.Timing.FrameMilliseconds;
+		for (std::size_t phase = 0; phase < framePhaseCount; phase++)
+			file << ", \"" << toString(static_cast<FramePhase>(phase)) << "_ms\": " << frame.Timing.PhaseMilliseconds[phase];
+		file << ", \"enemies\": " << frame.Enemies
+			<< ", \"projectiles\": " << frame.Projectiles
+			<< ", \"allocations\": " << frame.Allocations
+			<< ", \"allocated_bytes\": " << frame.AllocatedBytes
+			<< " }";
+	}
+
+	file << "\n  ]\n}\n";
+	return static_cast<bool>(file);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FrameTimings.h"
+
+struct HitchFrame
+{
+	std::uint64_t Index{};
+	std::chrono::steady_clock::time_point End{};
+	FrameSample Timing{};
+	std::size_t Enemies{};
+	std::size_t Projectiles{};
+	std::uint64_t Allocations{}; // during this frame
+	std::uint64_t AllocatedBytes{};
+};
+
+// Watches the frame loop for frames over budget. It always keeps the last
+// few seconds of frames in a ring buffer; when a frame goes over budget, it
+// saves those frames to hitch_<n>.json and the trace zones of the same
+// stretch of time to hitch_<n>_trace.json, so a hitch that can't be
+// reproduced can still be looked at. Recording a frame copies one small
+// struct and doesn't allocate. The files are written on a thread of their
+// own, so saving doesn't make the frames after a hitch hitch too.
+class HitchDetector
+{
+public:
+	HitchDetector(float budgetMilliseconds, float historySeconds, float cooldownSeconds);
+
+	// Returns the path of the frames file when this frame was a hitch and
+	// is being saved. Hitches within cooldownSeconds of the last saved one,
+	// or while the last one is still being written, are counted but not saved.
+	std::optional<std::string> recordFrame(const FrameSample& timing, std::size_t enemies, std::size_t projectiles);
+
+	float getBudgetMilliseconds() const { return BudgetMilliseconds; }
+	std::size_t getHitchCount() const { return HitchCount; }
+
+private:
+	float BudgetMilliseconds{};
+	std::chrono::duration<float> History{};
+	std::chrono::duration<float> Cooldown{};
+	std::vector<HitchFrame> Frames;
+	std::size_t Next{};
+	std::size_t Count{};
+	std::uint64_t FrameIndex{};
+	std::uint64_t LastAllocations{};
+	std::uint64_t LastAllocatedBytes{};
+	std::size_t HitchCount{};
+	std::size_t SavedCount{};
+	std::optional<std::chrono::steady_clock::time_point> LastSaved{};
+	// The frames of the hitch being written, oldest first. Only the writer
+	// touches them while Writing is set.
+	std::vector<HitchFrame> SavedFrames;
+	std::atomic<bool> Writing{};
+	std::jthread Writer;
+
+	const HitchFrame& getFrame(std::size_t age) const;
+	void write(std::string path, HitchFrame hitch, std::uint64_t traceSince);
+	bool save(const std::string& path, const HitchFrame& hitch) const;
+};
@@ -0,0 +1,134 @@
+#include "InputCache.h"
+
+std::vector<std::pair<Action, InputBinding>> defaultBindings()
+{
+	return {
+		{ Action::MoveUp, sf::Keyboard::Key::W },
+		{ Action::MoveLeft, sf::Keyboard::Key::A },
+		{ Action::MoveDown, sf::Keyboard::Key::S },
+		{ Action::MoveRight, sf::Keyboard::Key::D },
+		{ Action::Fire, sf::Mouse::Button::Left },
+		{ Action::SaveTimingsCsv, sf::Keyboard::Key::F5 },
+		{ Action::SaveTimingsJson, sf::Keyboard::Key::F6 },
+		{ Action::SaveTrace, sf::Keyboard::Key::F7 },
+		{ Action::SelectMovement1, sf::Keyboard::Key::Num1 },
+		{ Action::SelectMovement2, sf::Keyboard::Key::Num2 },
+		{ Action::SelectMovement3, sf::Keyboard::Key::Num3 },
+		{ Action::SelectMovement4, sf::Keyboard::Key::Num4 },
+		{ Action::SelectMovement5, sf::Keyboard::Key::Num5 },
+	};
+}
+
+InputCache::InputCache(std::vector<std::pair<Action, InputBinding>> bindings)
+	: Bindings(std::move(bindings))
+{
+}
+
+void InputCache::handleEvent(const sf::Event& event)
+{
+	if (const auto* keyPressed = event.getIf<sf::Event::KeyPressed>())
+	{
+		if (keyPressed->code != sf::Keyboard::Key::Unknown)
+			press(indexOf(keyPressed->code));
+	}
+	else if (const auto* keyReleased = event.getIf<sf::Event::KeyReleased>())
+	{
+		if (keyReleased->code != sf::Keyboard::Key::Unknown)
+			release(indexOf(keyReleased->code));
+	}
+	else if (const auto* buttonPressed = event.getIf<sf::Event::MouseButtonPressed>())
+	{
+		press(indexOf(buttonPressed->button));
+		MousePosition = buttonPressed->position;
+	}
+	else if (const auto* buttonReleased = event.getIf<sf::Event::MouseButtonReleased>())
+	{
+		release(indexOf(buttonReleased->button));
+		MousePosition = buttonReleased->position;
+	}
+	else if (const auto* mouseMoved = event.getIf<sf::Event::MouseMoved>())
+	{
+		MousePosition = mouseMoved->position;
+	}
+	else if (event.is<sf::Event::FocusLost>())
+	{
+		// Releases that happen in another window never reach this one.
+		Released |= Down;
+		Down.reset();
+	}
+}
+
+void InputCache::endFrame()
+{
+	Pressed.reset();
+	Released.reset();
+}
+
+bool InputCache::isDown(sf::Keyboard::Key key) const
+{
+	return key != sf::Keyboard::Key::Unknown && Down[indexOf(key)];
+}
+
+bool InputCache::wasPressed(sf::Keyboard::Key key) const
+{
+	return key != sf::Keyboard::Key::Unknown && Pressed[indexOf(key)];
+}
+
+bool InputCache::isDown(sf::Mouse::Button button) const
+{
+	return Down[indexOf(button)];
+}
+
+bool InputCache::wasPressed(sf::Mouse::Button button) const
+{
+	return Pressed[indexOf(button)];
+}
+
+bool InputCache::isDown(Action action) const
+{
+	return anyBound(action, Down);
+}
+
+bool InputCache::wasPressed(Action action) const
+{
+	return anyBound(action, Pressed);
+}
+
+bool InputCache::wasReleased(Action action) const
+{
+	return anyBound(action, Released);
+}
+
+std::size_t InputCache::indexOf(const InputBinding& binding)
+{
+	if (const auto* key = std::get_if<sf::Keyboard::Key>(&binding))
+		return static_cast<std::size_t>(*key);
+
+	return sf::Keyboard::KeyCount + static_cast<std::size_t>(std::get<sf::Mouse::Button>(binding));
+}
+
+void InputCache::press(std::size_t index)
+{
+	// Key repeat sends more presses while a key is held; only the first one is an edge.
+	if (!Down[index])
+		Pressed.set(index);
+	Down.set(index);
+}
+
+void InputCache::release(std::size_t index)
+{
+	if (Down[index])
+		Released.set(index);
+	Down.reset(index);
+}
+
+bool InputCache::anyBound(Action action, const std::bitset<inputCount>& state) const
+{
+	for (const auto& [boundAction, binding] : Bindings)
+	{
+		if (boundAction == action && state[indexOf(binding)])
+			return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Window/Event.hpp>
+#include <SFML/Window/Keyboard.hpp>
+#include <SFML/Window/Mouse.hpp>
+
+enum class Action
+{
+	MoveUp,
+	MoveLeft,
+	MoveDown,
+	MoveRight,
+	Fire,
+	SaveTimingsCsv,
+	SaveTimingsJson,
+	SaveTrace,
+	// Which movement model the player's projectiles use, in order.
+	SelectMovement1,
+	SelectMovement2,
+	SelectMovement3,
+	SelectMovement4,
+	SelectMovement5,
+};
+
+constexpr std::size_t actionCount = 13;
+constexpr std::size_t selectMovementActionCount = 5;
+
+// The action that selects movement model index.
+constexpr Action getSelectMovementAction(std::size_t index)
+{
+	return static_cast<Action>(static_cast<std::size_t>(Action::SelectMovement1) + index);
+}
+
+using InputBinding = std::variant<sf::Keyboard::Key, sf::Mouse::Button>;
+
+// WASD to move, left mouse button to fire, 1 to 5 to pick a movement model,
+// F5 to F7 to save timings.
+std::vector<std::pair<Action, InputBinding>> defaultBindings();
+
+// Keyboard and mouse state built from window events, so reading input is a
+// lookup instead of asking the OS about every key each frame. Besides which
+// keys and buttons are down, it keeps which ones went down or up since the
+// last endFrame(); a press and release within one frame still shows as
+// pressed. Bindings map actions to keys and buttons, several per action.
+class InputCache
+{
+public:
+	explicit InputCache(std::vector<std::pair<Action, InputBinding>> bindings = defaultBindings());
+
+	void handleEvent(const sf::Event& event);
+	// Forgets the presses and releases seen so far.
+	void endFrame();
+
+	bool isDown(sf::Keyboard::Key key) const;
+	bool wasPressed(sf::Keyboard::Key key) const;
+	bool isDown(sf::Mouse::Button button) const;
+	bool wasPressed(sf::Mouse::Button button) const;
+
+	// True when any key or button bound to the action is.
+	bool isDown(Action action) const;
+	bool wasPressed(Action action) const;
+	bool wasReleased(Action action) const;
+
+	sf::Vector2i getMousePosition() const { return MousePosition; }
+	// Events only report the mouse once it moves or clicks, so the position
+	// it starts at has to be set once, e.g. from sf::Mouse::getPosition(window).
+	void setMousePosition(sf::Vector2i position) { MousePosition = position; }
+
+private:
+	// Keys first, then mouse buttons.
+	static constexpr std::size_t inputCount = sf::Keyboard::KeyCount + sf::Mouse::ButtonCount;
+
+	std::vector<std::pair<Action, InputBinding>> Bindings;
+	std::bitset<inputCount> Down;
+	std::bitset<inputCount> Pressed;
+	std::bitset<inputCount> Released;
+	sf::Vector2i MousePosition{};
+
+	static std::size_t indexOf(const InputBinding& binding);
+	void press(std::size_t index);
+	void release(std::size_t index);
+	bool anyBound(Action action, const std::bitset<inputCount>& state) const;
+};
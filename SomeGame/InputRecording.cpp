@@ -0,0 +1,221 @@
+#include "InputRecording.h"
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <limits>
+
+#include "BulletPattern.h"
+
+namespace
+{
+	constexpr std::array<char, 4> recordingMagic{ 'S', 'G', 'I', 'R' };
+	constexpr std::uint32_t recordingVersion = 3;
+
+	enum InputKeys : std::uint8_t
+	{
+		KeyUp = 1 << 0,
+		KeyLeft = 1 << 1,
+		KeyDown = 1 << 2,
+		KeyRight = 1 << 3,
+		KeyFire = 1 << 4,
+	};
+
+	// Values are written as their bytes; every platform the game builds for is little endian.
+	template <typename T>
+	void write(std::ofstream& file, T value)
+	{
+		file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+	}
+
+	template <typename T>
+	bool read(std::ifstream& file, T& value)
+	{
+		return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+	}
+
+	// Names are short enough for a one byte length.
+	void writeName(std::ofstream& file, const std::string& name)
+	{
+		const auto length = std::min<std::size_t>(name.size(), std::numeric_limits<std::uint8_t>::max());
+		write(file, static_cast<std::uint8_t>(length));
+		file.write(name.data(), static_cast<std::streamsize>(length));
+	}
+
+	bool readName(std::ifstream& file, std::string& name)
+	{
+		std::uint8_t length{};
+		if (!read(file, length))
+			return false;
+		name.resize(length);
+		return static_cast<bool>(file.read(name.data(), length));
+	}
+
+	std::uint8_t packKeys(const InputState& input)
+	{
+		return static_cast<std::uint8_t>(
+			(input.MoveUp ? KeyUp : 0)
+			| (input.MoveLeft ? KeyLeft : 0)
+			| (input.MoveDown ? KeyDown : 0)
+			| (input.MoveRight ? KeyRight : 0)
+			| (input.Fire ? KeyFire : 0));
+	}
+
+	std::optional<std::string> adoptRecordedPattern(const std::string& recorded, std::string& given, const std::string& option)
+	{
+		if (!given.empty() && given != recorded)
+		{
+			return "The recording was made " + (recorded.empty() ? "without " + option : "with " + option + " " + recorded)
+				+ ", not with " + option + " " + given;
+		}
+		if (!recorded.empty() && !findBulletPattern(recorded))
+			return "The recording uses the unknown bullet pattern " + recorded;
+
+		given = recorded;
+		return std::nullopt;
+	}
+
+	void unpackKeys(std::uint8_t keys, InputState& input)
+	{
+		input.MoveUp = keys & KeyUp;
+		input.MoveLeft = keys & KeyLeft;
+		input.MoveDown = keys & KeyDown;
+		input.MoveRight = keys & KeyRight;
+		input.Fire = keys & KeyFire;
+	}
+}
+
+std::string toString(const Scenario& scenario)
+{
+	return "--enemies " + std::to_string(scenario.Enemies)
+		+ " --waves " + std::to_string(scenario.WaveSize)
+		+ " --collision " + (scenario.Collision == CollisionMode::Discrete ? "discrete" : "continuous");
+}
+
+void InputRecording::record(const InputState& input)
+{
+	if (Segments.empty() || Segments.back().Input != input
+		|| Segments.back().Ticks == std::numeric_limits<std::uint32_t>::max())
+		Segments.push_back({ 0, input });
+
+	Segments.back().Ticks++;
+	Ticks++;
+}
+
+bool InputRecording::save(const std::string& path) const
+{
+	std::ofstream file{ path, std::ios::binary };
+	if (!file)
+		return false;
+
+	file.write(recordingMagic.data(), recordingMagic.size());
+	write(file, recordingVersion);
+	write(file, StepSeconds);
+	write(file, static_cast<std::uint8_t>(Kernel));
+	writeName(file, EnemyPattern);
+	writeName(file, PlayerPattern);
+	write(file, static_cast<std::uint32_t>(Setup.Enemies));
+	write(file, static_cast<std::uint32_t>(Setup.WaveSize));
+	write(file, static_cast<std::uint8_t>(Setup.Collision));
+
+	for (const auto& segment : Segments)
+	{
+		write(file, static_cast<std::uint32_t>(segment.Ticks));
+		write(file, packKeys(segment.Input));
+		write(file, segment.Input.AimPosition.x);
+		write(file, segment.Input.AimPosition.y);
+		write(file, static_cast<std::uint8_t>(segment.Input.SelectMovement ? *segment.Input.SelectMovement + 1 : 0));
+	}
+	write(file, std::uint32_t{ 0 });
+
+	write(file, Ticks);
+	write(file, FinalChecksum);
+	return static_cast<bool>(file);
+}
+
+std::optional<InputRecording> InputRecording::load(const std::string& path)
+{
+	std::ifstream file{ path, std::ios::binary };
+	if (!file)
+		return std::nullopt;
+
+	std::array<char, 4> magic{};
+	std::uint32_t version{};
+	std::uint8_t kernel{};
+	std::uint32_t enemies{};
+	std::uint32_t waveSize{};
+	std::uint8_t collision{};
+	InputRecording recording{};
+	if (!file.read(magic.data(), magic.size()) || magic != recordingMagic
+		|| !read(file, version) || version != recordingVersion
+		|| !read(file, recording.StepSeconds)
+		|| !read(file, kernel)
+		|| !readName(file, recording.EnemyPattern)
+		|| !readName(file, recording.PlayerPattern)
+		|| !read(file, enemies)
+		|| !read(file, waveSize)
+		|| !read(file, collision))
+		return std::nullopt;
+	recording.Kernel = static_cast<KernelLevel>(kernel);
+	recording.Setup = { enemies, waveSize, static_cast<CollisionMode>(collision) };
+
+	while (true)
+	{
+		std::uint32_t ticks{};
+		if (!read(file, ticks))
+			return std::nullopt;
+		if (ticks == 0)
+			break;
+
+		InputSegment segment{ ticks };
+		std::uint8_t keys{};
+		std::uint8_t movement{};
+		if (!read(file, keys) || !read(file, segment.Input.AimPosition.x) || !read(file, segment.Input.AimPosition.y) || !read(file, movement))
+			return std::nullopt;
+
+		unpackKeys(keys, segment.Input);
+		if (movement > 0)
+			segment.Input.SelectMovement = movement - 1;
+		recording.Segments.push_back(segment);
+	}
+
+	if (!read(file, recording.Ticks) || !read(file, recording.FinalChecksum))
+		return std::nullopt;
+
+	return recording;
+}
+
+std::optional<std::string> adoptRecordedPatterns(const InputRecording& recording, std::string& enemyPattern, std::string& playerPattern)
+{
+	if (auto error = adoptRecordedPattern(recording.EnemyPattern, enemyPattern, "--pattern"))
+		return error;
+	return adoptRecordedPattern(recording.PlayerPattern, playerPattern, "--player-pattern");
+}
+
+std::optional<std::string> adoptRecordedScenario(const InputRecording& recording, Scenario& scenario, bool scenarioGiven)
+{
+	if (scenarioGiven && scenario != recording.Setup)
+		return "The recording was made with " + toString(recording.Setup) + ", not " + toString(scenario);
+
+	scenario = recording.Setup;
+	return std::nullopt;
+}
+
+InputPlayback::InputPlayback(const InputRecording& recording)
+	: Recording(&recording)
+{
+}
+
+std::optional<InputState> InputPlayback::next()
+{
+	if (isFinished())
+		return std::nullopt;
+
+	const auto input = Recording->Segments[Segment].Input;
+	if (++TicksInSegment >= Recording->Segments[Segment].Ticks)
+	{
+		Segment++;
+		TicksInSegment = 0;
+	}
+	return input;
+}
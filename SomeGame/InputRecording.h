@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Simulation.h"
+
+// What a headless run sets up besides the input: the enemies it starts
+// with, the waves it spawns every second and how projectiles collide. The
+// windowed game always plays the default one.
+struct Scenario
+{
+	std::size_t Enemies = 1;
+	std::size_t WaveSize = 0;
+	CollisionMode Collision = projectileCollisionMode;
+
+	bool operator==(const Scenario&) const = default;
+};
+
+// The options that set up scenario, e.g. "--enemies 1 --waves 0 --collision continuous".
+std::string toString(const Scenario& scenario);
+
+// The same input for Ticks simulation steps in a row.
+struct InputSegment
+{
+	std::size_t Ticks{};
+	InputState Input{};
+};
+
+// The input of every simulation step of a session. Steps only depend on
+// their input, the step length, the bullet patterns and the scenario, so
+// playing a recording back with the same step length, patterns and
+// scenario repeats the session exactly, on the same build and kernel
+// level. The checksum of the final state shows whether it did.
+//
+// Saved as a small binary file, little endian:
+//	header   "SGIR", u32 version, f32 step seconds, u8 kernel level,
+//	         enemy pattern, player pattern (u8 length, then the name; empty for none)
+//	         u32 enemies, u32 wave size, u8 collision mode
+//	segments u32 ticks, u8 keys, f32 aim x, f32 aim y, u8 movement (0 = none, else index + 1)
+//	         ... until a segment with 0 ticks
+//	footer   u64 ticks, u64 final state checksum
+// Runs of identical steps share a segment, so an idle minute is one segment.
+struct InputRecording
+{
+	float StepSeconds{};
+	KernelLevel Kernel = detectKernelLevel();
+	// Names as given to --pattern and --player-pattern, empty without one.
+	std::string EnemyPattern{};
+	std::string PlayerPattern{};
+	Scenario Setup{};
+	std::vector<InputSegment> Segments{};
+	std::uint64_t Ticks{};
+	std::uint64_t FinalChecksum{};
+
+	// Appends one step's input.
+	void record(const InputState& input);
+
+	bool save(const std::string& path) const;
+	// Returns nothing when the file can't be read or isn't a recording.
+	static std::optional<InputRecording> load(const std::string& path);
+};
+
+// Takes a recording's bullet patterns into the ones given on the command
+// line for a replay. Returns why the replay can't run when a different
+// pattern was given or the recorded one doesn't exist in this build.
+std::optional<std::string> adoptRecordedPatterns(const InputRecording& recording, std::string& enemyPattern, std::string& playerPattern);
+
+// Takes a recording's scenario for a replay when none was given on the
+// command line. Returns why the replay can't run when the given one differs.
+std::optional<std::string> adoptRecordedScenario(const InputRecording& recording, Scenario& scenario, bool scenarioGiven);
+
+// Hands out a recording's input one step at a time.
+class InputPlayback
+{
+public:
+	explicit InputPlayback(const InputRecording& recording);
+
+	// Input for the next step, or nothing once the recording is over.
+	std::optional<InputState> next();
+	bool isFinished() const { return Segment >= Recording->Segments.size(); }
+
+private:
+	const InputRecording* Recording;
+	std::size_t Segment{};
+	std::size_t TicksInSegment{};
+};
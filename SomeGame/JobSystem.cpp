@@ -0,0 +1,204 @@
+#include "JobSystem.h"
+
+#include <cassert>
+
+#include "Trace.h"
+
+namespace
+{
+	// Which pool the current thread works for, and its queue in that pool.
+	thread_local const JobSystem* currentPool{};
+	thread_local std::size_t currentQueue{};
+}
+
+JobId JobGraph::addJob(std::function<void()> work)
+{
+	auto node = std::make_unique<Node>();
+	node->Work = std::move(work);
+	node->Graph = this;
+	Nodes.push_back(std::move(node));
+	return Nodes.size() - 1;
+}
+
+void JobGraph::precede(JobId before, JobId after)
+{
+	assert(before < Nodes.size() && after < Nodes.size() && before != after);
+
+	Nodes[before]->Successors.push_back(after);
+	Nodes[after]->Dependencies++;
+}
+
+JobSystem::JobSystem(std::size_t threadCount)
+{
+	threadCount = std::max<std::size_t>(threadCount, 1);
+
+	Queues.reserve(threadCount);
+	for (std::size_t i = 0; i < threadCount; i++)
+		Queues.push_back(std::make_unique<WorkerQueue>());
+
+	Workers.reserve(threadCount - 1);
+	for (std::size_t i = 1; i < threadCount; i++)
+		Workers.emplace_back([this, i] { workerLoop(i); });
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard lock{ SleepMutex };
+		Stopping = true;
+	}
+	WakeUp.notify_all();
+	Workers.clear();
+}
+
+void JobSystem::submit(const Job& job)
+{
+	job.Counter->Pending.fetch_add(1, std::memory_order_relaxed);
+
+	// Counted before it is queued so a thread that takes it never sees the count go below zero.
+	QueuedJobs.fetch_add(1, std::memory_order_release);
+
+	auto& queue = *Queues[getQueueIndex()];
+	{
+		std::unique_lock lock{ queue.Mutex };
+		if (queue.Count == jobQueueCapacity)
+		{
+			lock.unlock();
+			QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+			runJob(job);
+			return;
+		}
+
+		queue.Jobs[(queue.Oldest + queue.Count) % jobQueueCapacity] = job;
+		queue.Count++;
+	}
+
+	if (!Workers.empty())
+	{
+		// Taking the lock orders this against a worker checking QueuedJobs before it sleeps.
+		{ std::lock_guard lock{ SleepMutex }; }
+		WakeUp.notify_one();
+	}
+}
+
+void JobSystem::wait(const JobCounter& counter)
+{
+	while (counter.Pending.load(std::memory_order_acquire) > 0)
+	{
+		if (!runOneJob())
+			std::this_thread::yield();
+	}
+}
+
+void JobSystem::run(JobGraph& graph)
+{
+	JobCounter counter;
+	graph.RunningOn = this;
+	graph.RunCounter = &counter;
+
+	for (auto& node : graph.Nodes)
+		node->Remaining.store(node->Dependencies, std::memory_order_relaxed);
+
+	for (auto& node : graph.Nodes)
+	{
+		if (node->Dependencies == 0)
+			submit({ &JobSystem::runGraphNode, node.get(), 0, 0, &counter });
+	}
+
+	wait(counter);
+	graph.RunningOn = nullptr;
+	graph.RunCounter = nullptr;
+}
+
+std::size_t JobSystem::getQueueIndex() const
+{
+	return currentPool == this ? currentQueue : 0;
+}
+
+bool JobSystem::takeJob(std::size_t queueIndex, Job& job)
+{
+	// Own queue newest first, the jobs it just submitted are still in cache.
+	{
+		auto& queue = *Queues[queueIndex];
+		std::lock_guard lock{ queue.Mutex };
+		if (queue.Count > 0)
+		{
+			queue.Count--;
+			job = queue.Jobs[(queue.Oldest + queue.Count) % jobQueueCapacity];
+			return true;
+		}
+	}
+
+	// Steal the oldest job of another queue, which tends to be the biggest piece of work left.
+	for (std::size_t offset = 1; offset < Queues.size(); offset++)
+	{
+		auto& queue = *Queues[(queueIndex + offset) % Queues.size()];
+		std::lock_guard lock{ queue.Mutex };
+		if (queue.Count > 0)
+		{
+			job = queue.Jobs[queue.Oldest];
+			queue.Oldest = (queue.Oldest + 1) % jobQueueCapacity;
+			queue.Count--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool JobSystem::runOneJob()
+{
+	if (QueuedJobs.load(std::memory_order_acquire) == 0)
+		return false;
+
+	Job job;
+	if (!takeJob(getQueueIndex(), job))
+		return false;
+
+	QueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+	runJob(job);
+	return true;
+}
+
+void JobSystem::runJob(const Job& job)
+{
+	{
+		TRACE_ZONE("job");
+		job.Function(job.Context, job.First, job.Count);
+	}
+	job.Counter->Pending.fetch_sub(1, std::memory_order_release);
+}
+
+void JobSystem::workerLoop(std::size_t queueIndex)
+{
+	currentPool = this;
+	currentQueue = queueIndex;
+	setTraceThreadName("worker");
+
+	while (true)
+	{
+		if (runOneJob())
+			continue;
+
+		std::unique_lock lock{ SleepMutex };
+		WakeUp.wait(lock, [this] { return Stopping || QueuedJobs.load(std::memory_order_acquire) > 0; });
+		if (Stopping)
+			return;
+	}
+}
+
+void JobSystem::runGraphNode(void* context, std::size_t, std::size_t)
+{
+	auto& node = *static_cast<JobGraph::Node*>(context);
+	node.Work();
+
+	// Successors are submitted before this job counts as done, so the run
+	// counter can't reach zero while any of them is still to come.
+	auto& graph = *node.Graph;
+	for (const auto successor : node.Successors)
+	{
+		auto& next = *graph.Nodes[successor];
+		if (next.Remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			graph.RunningOn->submit({ &JobSystem::runGraphNode, &next, 0, 0, graph.RunCounter });
+	}
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Counts the jobs submitted against it that haven't finished yet.
+struct JobCounter
+{
+	std::atomic<std::size_t> Pending{};
+};
+
+// A job is a plain function pointer over a range, so submitting one never
+// allocates. Context points at whatever the function needs.
+struct Job
+{
+	void (*Function)(void* context, std::size_t first, std::size_t count) {};
+	void* Context{};
+	std::size_t First{};
+	std::size_t Count{};
+	JobCounter* Counter{};
+};
+
+class JobSystem;
+
+using JobId = std::size_t;
+
+// Jobs and the order they have to run in. Build it once and run it as often
+// as needed: a job starts as soon as every job it depends on has finished,
+// so independent jobs run at the same time.
+class JobGraph
+{
+public:
+	JobId addJob(std::function<void()> work);
+
+	// after won't start before before has finished.
+	void precede(JobId before, JobId after);
+
+	std::size_t size() const { return Nodes.size(); }
+
+private:
+	friend class JobSystem;
+
+	struct Node
+	{
+		std::function<void()> Work;
+		std::vector<JobId> Successors;
+		std::size_t Dependencies{};
+		std::atomic<std::size_t> Remaining{};
+		JobGraph* Graph{};
+	};
+
+	std::vector<std::unique_ptr<Node>> Nodes;
+	JobSystem* RunningOn{};
+	JobCounter* RunCounter{};
+};
+
+// Jobs one queue holds before submit() runs the next one right away.
+constexpr std::size_t jobQueueCapacity = 1024;
+
+// Work-stealing thread pool. Every thread has its own queue: it takes its
+// newest job first, and an idle thread steals the oldest job of another
+// queue. Queues are fixed rings, so submitting never allocates; a job that
+// finds its queue full runs inside submit() instead. Threads that wait on a counter run jobs while they wait, so jobs can
+// submit and wait on more jobs without deadlocking.
+// threadCount includes the thread that waits; with 1 there are no workers
+// and every job runs inside wait().
+class JobSystem
+{
+public:
+	explicit JobSystem(std::size_t threadCount = std::thread::hardware_concurrency());
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	std::size_t getThreadCount() const { return Workers.size() + 1; }
+
+	void submit(const Job& job);
+	void wait(const JobCounter& counter);
+
+	// Calls function(first, count) on chunks of [0, count) across all threads
+	// and returns once every chunk is done.
+	template <typename Function>
+	void parallelFor(std::size_t count, std::size_t chunkSize, Function&& function)
+	{
+		if (count == 0)
+			return;
+
+		using FunctionType = std::remove_reference_t<Function>;
+		if (count <= chunkSize || Workers.empty())
+		{
+			function(std::size_t{ 0 }, count);
+			return;
+		}
+
+		JobCounter counter;
+		for (std::size_t first = 0; first < count; first += chunkSize)
+		{
+			submit({
+				[](void* context, std::size_t first, std::size_t count) { (*static_cast<FunctionType*>(context))(first, count); },
+				const_cast<void*>(static_cast<const void*>(&function)),
+				first,
+				std::min(chunkSize, count - first),
+				&counter });
+		}
+		wait(counter);
+	}
+
+	void run(JobGraph& graph);
+
+private:
+	// Jobs[(Oldest + i) % jobQueueCapacity] for i < Count.
+	struct WorkerQueue
+	{
+		std::mutex Mutex;
+		std::vector<Job> Jobs = std::vector<Job>(jobQueueCapacity);
+		std::size_t Oldest{};
+		std::size_t Count{};
+	};
+
+	std::vector<std::unique_ptr<WorkerQueue>> Queues; // queue 0 belongs to threads outside the pool
+	std::vector<std::jthread> Workers;
+	std::atomic<std::size_t> QueuedJobs{};
+	std::mutex SleepMutex;
+	std::condition_variable WakeUp;
+	bool Stopping{};
+
+	std::size_t getQueueIndex() const;
+	bool takeJob(std::size_t queueIndex, Job& job);
+	static void runJob(const Job& job);
+	bool runOneJob();
+	void workerLoop(std::size_t queueIndex);
+
+	static void runGraphNode(void* context, std::size_t, std::size_t);
+};
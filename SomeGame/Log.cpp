@@ -0,0 +1,225 @@
+#include "Log.h"
+
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stop_token>
+#include <string>
+#include <thread>
+
+#include "Trace.h"
+
+namespace
+{
+	constexpr std::size_t logCapacity = 4096; // records, a power of two
+	constexpr auto writerIdleSleep = std::chrono::milliseconds(5);
+
+	// A bounded queue after Dmitry Vyukov's: every slot carries a sequence
+	// number that says whose turn it is, so producers only race on one
+	// counter and never wait for each other or for the writer.
+	struct LogSlot
+	{
+		std::atomic<std::uint64_t> Sequence{};
+		LogRecord Record;
+	};
+
+	class Logger
+	{
+	public:
+		Logger()
+			: Slots(std::make_unique<LogSlot[]>(logCapacity)), Start(std::chrono::steady_clock::now())
+		{
+			for (std::size_t i = 0; i < logCapacity; i++)
+				Slots[i].Sequence.store(i, std::memory_order_relaxed);
+
+			Writer = std::jthread([this](std::stop_token stop) { run(stop); });
+		}
+
+		~Logger()
+		{
+			Writer.request_stop();
+			Writer.join();
+		}
+
+		bool push(const LogRecord& record)
+		{
+			auto position = EnqueuePosition.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				auto& slot = Slots[position & (logCapacity - 1)];
+				const auto sequence = slot.Sequence.load(std::memory_order_acquire);
+				const auto difference = static_cast<std::int64_t>(sequence - position);
+				if (difference == 0)
+				{
+					if (EnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					{
+						slot.Record = record;
+						slot.Sequence.store(position + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (difference < 0)
+				{
+					// The writer hasn't taken this slot's last record yet: full.
+					Dropped.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+				else
+				{
+					position = EnqueuePosition.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		void flush()
+		{
+			const auto pushed = EnqueuePosition.load(std::memory_order_acquire);
+			while (Written.load(std::memory_order_acquire) < pushed)
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+
+		std::atomic<LogLevel> Level{ LogLevel::Debug };
+
+	private:
+		std::unique_ptr<LogSlot[]> Slots;
+		std::atomic<std::uint64_t> EnqueuePosition{};
+		std::atomic<std::uint64_t> Written{};
+		std::atomic<std::uint64_t> Dropped{};
+		std::uint64_t DequeuePosition{};
+		std::uint64_t ReportedDropped{};
+		std::chrono::steady_clock::time_point Start;
+		std::string Buffer;
+		std::jthread Writer;
+
+		void run(std::stop_token stop)
+		{
+			setTraceThreadName("log");
+			while (!stop.stop_requested())
+			{
+				if (!drain())
+					std::this_thread::sleep_for(writerIdleSleep);
+			}
+
+			drain();
+		}
+
+		// Formats everything that is in the ring and writes it with one
+		// flush. Returns false when there was nothing to write.
+		bool drain()
+		{
+			Buffer.clear();
+			for (;;)
+			{
+				auto& slot = Slots[DequeuePosition & (logCapacity - 1)];
+				if (slot.Sequence.load(std::memory_order_acquire) != DequeuePosition + 1)
+					break;
+
+				format(slot.Record);
+				slot.Sequence.store(DequeuePosition + logCapacity, std::memory_order_release);
+				DequeuePosition++;
+			}
+
+			const auto dropped = Dropped.load(std::memory_order_relaxed);
+			if (dropped != ReportedDropped)
+			{
+				Buffer += "[warning] " + std::to_string(dropped - ReportedDropped) + " log messages dropped, the log was full\n";
+				ReportedDropped = dropped;
+			}
+
+			if (Buffer.empty())
+				return false;
+
+			std::cout.write(Buffer.data(), static_cast<std::streamsize>(Buffer.size()));
+			std::cout.flush();
+			Written.store(DequeuePosition, std::memory_order_release);
+			return true;
+		}
+
+		void format(const LogRecord& record)
+		{
+			const std::chrono::duration<double> time = record.Time - Start;
+			std::ostringstream line;
+			line << std::fixed << std::setprecision(3) << "[" << time.count() << " " << toString(record.Level) << "] ";
+			line.unsetf(std::ios::floatfield);
+			line << std::setprecision(6) << std::boolalpha;
+
+			std::size_t next = 0;
+			for (const char* c = record.Format; *c != '\0'; c++)
+			{
+				if (c[0] != '{' || c[1] != '}' || next >= record.ArgumentCount)
+				{
+					line << *c;
+					continue;
+				}
+
+				const auto& argument = record.Arguments[next++];
+				switch (argument.Kind)
+				{
+				case LogArgument::Type::Signed:
+					line << argument.Signed;
+					break;
+				case LogArgument::Type::Unsigned:
+					line << argument.Unsigned;
+					break;
+				case LogArgument::Type::Floating:
+					line << argument.Floating;
+					break;
+				case LogArgument::Type::Boolean:
+					line << argument.Boolean;
+					break;
+				case LogArgument::Type::Text:
+					line << std::string_view{ record.Text.data() + argument.TextOffset, argument.TextLength };
+					break;
+				}
+				c++;
+			}
+
+			line << '\n';
+			Buffer += line.str();
+		}
+	};
+
+	Logger& getLogger()
+	{
+		static Logger logger;
+		return logger;
+	}
+}
+
+const char* toString(LogLevel level)
+{
+	switch (level)
+	{
+	case LogLevel::Debug:
+		return "debug";
+	case LogLevel::Info:
+		return "info";
+	case LogLevel::Warning:
+		return "warning";
+	case LogLevel::Error:
+		return "error";
+	}
+	return "unknown";
+}
+
+void setLogLevel(LogLevel level)
+{
+	getLogger().Level.store(level, std::memory_order_relaxed);
+}
+
+bool isLogLevelEnabled(LogLevel level)
+{
+	return level >= getLogger().Level.load(std::memory_order_relaxed);
+}
+
+void flushLog()
+{
+	getLogger().flush();
+}
+
+bool pushLogRecord(const LogRecord& record)
+{
+	return getLogger().push(record);
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+// Asynchronous logging that is safe to call from the frame loop and jobs:
+//	LOG_INFO("Saved {} frames to {}", count, path);
+// copies the arguments into a lock-free ring buffer and returns. A
+// background thread replaces each {} with the next argument, formats the
+// message and writes it to stdout, so the calling thread never formats,
+// locks or waits for the console. When the ring is full the message is
+// dropped and counted instead of blocking. Lines start with the seconds
+// since the first message and the level.
+// Format strings have to be string literals. Strings are copied, up to
+// logTextCapacity characters per message, numbers and bools by value.
+//
+// LOG_DEBUG compiles to nothing, arguments included, unless
+// SOMEGAME_LOG_DEBUG is 1, which it is by default in builds without NDEBUG.
+
+#ifndef SOMEGAME_LOG_DEBUG
+#ifdef NDEBUG
+#define SOMEGAME_LOG_DEBUG 0
+#else
+#define SOMEGAME_LOG_DEBUG 1
+#endif
+#endif
+
+enum class LogLevel : std::uint8_t
+{
+	Debug,
+	Info,
+	Warning,
+	Error,
+};
+
+const char* toString(LogLevel level);
+
+// Messages below level are dropped where they are logged. Debug by default.
+void setLogLevel(LogLevel level);
+bool isLogLevelEnabled(LogLevel level);
+
+// Blocks until every message logged so far has been written.
+void flushLog();
+
+constexpr std::size_t maxLogArguments = 6;
+constexpr std::size_t logTextCapacity = 64;
+
+struct LogArgument
+{
+	enum class Type : std::uint8_t
+	{
+		Signed,
+		Unsigned,
+		Floating,
+		Boolean,
+		Text,
+	};
+
+	Type Kind;
+	union
+	{
+		std::int64_t Signed;
+		std::uint64_t Unsigned;
+		double Floating;
+		bool Boolean;
+	};
+	// Where a Text argument is in the record's Text.
+	std::uint16_t TextOffset;
+	std::uint16_t TextLength;
+};
+
+// One message as it travels to the writer thread. Nothing is initialized
+// that the message doesn't use.
+struct LogRecord
+{
+	const char* Format;
+	std::chrono::steady_clock::time_point Time;
+	LogLevel Level;
+	std::uint8_t ArgumentCount;
+	std::uint16_t TextUsed;
+	std::array<LogArgument, maxLogArguments> Arguments;
+	std::array<char, logTextCapacity> Text;
+};
+
+// Hands a record to the writer thread. Returns false when it was dropped.
+bool pushLogRecord(const LogRecord& record);
+
+namespace LogDetail
+{
+	template <typename T>
+	void append(LogRecord& record, const T& value)
+	{
+		auto& argument = record.Arguments[record.ArgumentCount++];
+		if constexpr (std::is_same_v<T, bool>)
+		{
+			argument.Kind = LogArgument::Type::Boolean;
+			argument.Boolean = value;
+		}
+		else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+		{
+			argument.Kind = LogArgument::Type::Signed;
+			argument.Signed = value;
+		}
+		else if constexpr (std::is_integral_v<T>)
+		{
+			argument.Kind = LogArgument::Type::Unsigned;
+			argument.Unsigned = value;
+		}
+		else if constexpr (std::is_floating_point_v<T>)
+		{
+			argument.Kind = LogArgument::Type::Floating;
+			argument.Floating = value;
+		}
+		else
+		{
+			static_assert(std::is_convertible_v<const T&, std::string_view>, "Only numbers, bools and strings can be logged");
+			const std::string_view text{ value };
+			const auto length = std::min(text.size(), logTextCapacity - record.TextUsed);
+			argument.Kind = LogArgument::Type::Text;
+			argument.TextOffset = record.TextUsed;
+			argument.TextLength = static_cast<std::uint16_t>(length);
+			std::copy_n(text.data(), length, record.Text.data() + record.TextUsed);
+			record.TextUsed = static_cast<std::uint16_t>(record.TextUsed + length);
+		}
+	}
+}
+
+template <typename... Arguments>
+void logMessage(LogLevel level, const char* format, const Arguments&... arguments)
+{
+	static_assert(sizeof...(Arguments) <= maxLogArguments, "Too many arguments for one log message");
+	if (!isLogLevelEnabled(level))
+		return;
+
+	LogRecord record;
+	record.Format = format;
+	record.Time = std::chrono::steady_clock::now();
+	record.Level = level;
+	record.ArgumentCount = 0;
+	record.TextUsed = 0;
+	(LogDetail::append(record, arguments), ...);
+	pushLogRecord(record);
+}
+
+#define LOG_INFO(...) logMessage(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARNING(...) logMessage(LogLevel::Warning, __VA_ARGS__)
+#define LOG_ERROR(...) logMessage(LogLevel::Error, __VA_ARGS__)
+
+#if SOMEGAME_LOG_DEBUG
+#define LOG_DEBUG(...) logMessage(LogLevel::Debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
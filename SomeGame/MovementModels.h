@@ -0,0 +1,202 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+
+#include <SFML/System/Vector2.hpp>
+
+#include "FastMath.h"
+#include "ProjectileKernels.h"
+#include "ProjectilePool.h"
+
+// Projectile movement models. Each one is a plain struct with its tuning
+// values and an update() that runs over a span of a pool at once, so there
+// is no per-projectile virtual call: ProjectileBuckets keeps one pool per
+// model and calls every model's update() on chunks of its own pool, possibly
+// on several threads at once. Models adjust velocity
+// (or position) column by column and then hand over to the integration
+// kernel, which moves, ages and bounds-checks everything in one pass.
+//
+// To add a model, write a struct with
+//	void update(const ProjectileSpan& projectiles, float deltaSeconds, const MovementContext& context) const
+// and add it to the ProjectileBuckets list.
+
+// Models that use the FastMath array forms go through their span in blocks
+// of this many, with the inputs and results on the stack.
+constexpr std::size_t movementBlockSize = 256;
+
+struct MovementContext
+{
+	sf::Vector2f Bounds{};
+	std::optional<sf::Vector2f> HomingTarget{};
+};
+
+// Straight line at the velocity resolved at spawn.
+struct LinearMovement
+{
+	void update(const ProjectileSpan& projectiles, float deltaSeconds, const MovementContext& context) const
+	{
+		integrateProjectiles(projectiles, deltaSeconds, context.Bounds);
+	}
+};
+
+// Turns towards the homing target, at most TurnRate of the way per second,
+// keeping its speed. Flies straight when there is nothing to home in on.
+struct HomingMovement
+{
+	float TurnRate = 4.f;
+
+	void update(const ProjectileSpan& projectiles, float deltaSeconds, const MovementContext& context) const
+	{
+		if (context.HomingTarget)
+		{
+			const auto targetX = context.HomingTarget->x;
+			const auto targetY = context.HomingTarget->y;
+			const auto blend = std::fmin(TurnRate * deltaSeconds, 1.f);
+
+			auto* x = projectiles.X;
+			auto* y = projectiles.Y;
+			auto* velocityX = projectiles.VelocityX;
+			auto* velocityY = projectiles.VelocityY;
+			for (std::size_t first = 0; first < projectiles.Count; first += movementBlockSize)
+			{
+				const auto count = std::min(movementBlockSize, projectiles.Count - first);
+
+				// sqrt(speed^2 / distance^2) as speed^2 / sqrt(speed^2 * distance^2), one
+				// reciprocal square root for the whole block.
+				float products[movementBlockSize];
+				float inverseRoots[movementBlockSize];
+				for (std::size_t i = 0; i < count; i++)
+				{
+					const auto j = first + i;
+					const auto toTargetX = targetX - x[j];
+					const auto toTargetY = targetY - y[j];
+					products[i] = (velocityX[j] * velocityX[j] + velocityY[j] * velocityY[j])
+						* (toTargetX * toTargetX + toTargetY * toTargetY);
+				}
+				fastRsqrt(products, inverseRoots, count);
+
+				for (std::size_t i = 0; i < count; i++)
+				{
+					// On the target or standing still, nothing to steer.
+					if (products[i] == 0.f)
+						continue;
+
+					const auto j = first + i;
+					const auto speedSquared = velocityX[j] * velocityX[j] + velocityY[j] * velocityY[j];
+					const auto desiredScale = speedSquared * inverseRoots[i];
+					velocityX[j] += ((targetX - x[j]) * desiredScale - velocityX[j]) * blend;
+					velocityY[j] += ((targetY - y[j]) * desiredScale - velocityY[j]) * blend;
+				}
+			}
+		}
+
+		integrateProjectiles(projectiles, deltaSeconds, context.Bounds);
+	}
+};
+
+// Falls under constant gravity, in px/s^2 along +y.
+struct BallisticMovement
+{
+	float Gravity = 600.f;
+
+	void update(const ProjectileSpan& projectiles, float deltaSeconds, const MovementContext& context) const
+	{
+		auto* velocityY = projectiles.VelocityY;
+		const auto count = projectiles.Count;
+		const auto deltaVelocity = Gravity * deltaSeconds;
+		for (std::size_t i = 0; i < count; i++)
+			velocityY[i] += deltaVelocity;
+
+		integrateProjectiles(projectiles, deltaSeconds, context.Bounds);
+	}
+};
+
+// Weaves sideways around its straight path, Amplitude px to either side.
+struct SineWaveMovement
+{
+	float Amplitude = 20.f;
+	float Frequency = 3.f; // waves per second
+
+	void update(const ProjectileSpan& projectiles, float deltaSeconds, const MovementContext& context) const
+	{
+		constexpr float twoPi = 6.28318530718f;
+		const auto angularFrequency = twoPi * Frequency;
+
+		auto* x = projectiles.X;
+		auto* y = projectiles.Y;
+		const auto* velocityX = projectiles.VelocityX;
+		const auto* velocityY = projectiles.VelocityY;
+		const auto* age = projectiles.Age;
+		for (std::size_t first = 0; first < projectiles.Count; first += movementBlockSize)
+		{
+			const auto count = std::min(movementBlockSize, projectiles.Count - first);
+
+			// A projectile fired during the step has a negative age and no offset before it.
+			float startPhases[movementBlockSize];
+			float endPhases[movementBlockSize];
+			float speedsSquared[movementBlockSize];
+			for (std::size_t i = 0; i < count; i++)
+			{
+				const auto j = first + i;
+				startPhases[i] = angularFrequency * std::max(age[j], 0.f);
+				endPhases[i] = angularFrequency * (age[j] + deltaSeconds);
+				speedsSquared[i] = velocityX[j] * velocityX[j] + velocityY[j] * velocityY[j];
+			}
+
+			float startOffsets[movementBlockSize];
+			float endOffsets[movementBlockSize];
+			float inverseSpeeds[movementBlockSize];
+			fastSinCos(startPhases, startOffsets, nullptr, count);
+			fastSinCos(endPhases, endOffsets, nullptr, count);
+			fastRsqrt(speedsSquared, inverseSpeeds, count);
+
+			for (std::size_t i = 0; i < count; i++)
+			{
+				if (speedsSquared[i] == 0.f)
+					continue;
+
+				// Move along the perpendicular by how much the sideways offset changes this step.
+				const auto j = first + i;
+				const auto offsetChange = Amplitude * inverseSpeeds[i] * (endOffsets[i] - startOffsets[i]);
+				x[j] -= velocityY[j] * offsetChange;
+				y[j] += velocityX[j] * offsetChange;
+			}
+		}
+
+		integrateProjectiles(projectiles, deltaSeconds, context.Bounds);
+	}
+};
+
+// Rotates its velocity at a constant rate while speeding up, tracing an
+// outward spiral from where it was fired.
+struct SpiralMovement
+{
+	float AngularSpeed = 4.f; // radians per second
+	float Acceleration = 0.5f; // relative speed gain per second
+
+	void update(const ProjectileSpan& projectiles, float deltaSeconds, const MovementContext& context) const
+	{
+		const auto turn = AngularSpeed * deltaSeconds;
+		const auto growth = 1.f + Acceleration * deltaSeconds;
+		float sine, cosine;
+		fastSinCos(turn, sine, cosine);
+		sine *= growth;
+		cosine *= growth;
+
+		auto* velocityX = projectiles.VelocityX;
+		auto* velocityY = projectiles.VelocityY;
+		const auto count = projectiles.Count;
+		for (std::size_t i = 0; i < count; i++)
+		{
+			const auto rotatedX = velocityX[i] * cosine - velocityY[i] * sine;
+			const auto rotatedY = velocityX[i] * sine + velocityY[i] * cosine;
+			velocityX[i] = rotatedX;
+			velocityY[i] = rotatedY;
+		}
+
+		integrateProjectiles(projectiles, deltaSeconds, context.Bounds);
+	}
+};
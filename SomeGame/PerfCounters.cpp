@@ -0,0 +1,224 @@
+#include "PerfCounters.h"
+
+#include <atomic>
+#include <cstdio>
+
+#include "Trace.h"
+
+#if SOMEGAME_PERF_COUNTERS
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	constexpr std::array<PerfPhase, perfPhaseCount> perfPhases
+	{
+		PerfPhase::ProjectileUpdate,
+		PerfPhase::Collision,
+		PerfPhase::Draw,
+	};
+
+	// Counter track names for the trace, which keeps the pointers.
+	struct PerfTrackNames
+	{
+		const char* InstructionsPerCycle;
+		const char* Instructions;
+		const char* CacheMisses;
+		const char* BranchMisses;
+	};
+
+	constexpr std::array<PerfTrackNames, perfPhaseCount> perfTrackNames
+	{ {
+		{ "projectile update IPC", "projectile update instructions", "projectile update cache misses", "projectile update branch misses" },
+		{ "collision IPC", "collision instructions", "collision cache misses", "collision branch misses" },
+		{ "draw IPC", "draw instructions", "draw cache misses", "draw branch misses" },
+	} };
+
+	struct PhaseTotals
+	{
+		std::atomic<std::uint64_t> Cycles{};
+		std::atomic<std::uint64_t> Instructions{};
+		std::atomic<std::uint64_t> CacheMisses{};
+		std::atomic<std::uint64_t> BranchMisses{};
+	};
+
+	std::array<PhaseTotals, perfPhaseCount> phaseTotals{};
+
+#if SOMEGAME_PERF_COUNTERS
+	// The four counters of one thread as a group, so one read() gets all of
+	// them from the same moment.
+	class ThreadCounters
+	{
+	public:
+		ThreadCounters()
+		{
+			constexpr std::array<std::uint64_t, 4> configs
+			{
+				PERF_COUNT_HW_CPU_CYCLES,
+				PERF_COUNT_HW_INSTRUCTIONS,
+				PERF_COUNT_HW_CACHE_MISSES,
+				PERF_COUNT_HW_BRANCH_MISSES,
+			};
+
+			for (std::size_t i = 0; i < configs.size(); i++)
+			{
+				perf_event_attr attributes{};
+				attributes.type = PERF_TYPE_HARDWARE;
+				attributes.size = sizeof(attributes);
+				attributes.config = configs[i];
+				attributes.read_format = PERF_FORMAT_GROUP;
+				attributes.exclude_kernel = 1;
+				attributes.exclude_hv = 1;
+
+				// This thread only, on whichever CPU it runs.
+				const auto groupLeader = i == 0 ? -1 : Descriptors[0];
+				Descriptors[i] = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, groupLeader, 0));
+				if (Descriptors[i] < 0)
+				{
+					close();
+					return;
+				}
+			}
+		}
+
+		~ThreadCounters() { close(); }
+
+		bool isOpen() const { return Descriptors[0] >= 0; }
+
+		bool read(PerfSample& sample) const
+		{
+			struct
+			{
+				std::uint64_t Count;
+				std::uint64_t Values[4];
+			} group{};
+
+			if (::read(Descriptors[0], &group, sizeof(group)) != static_cast<ssize_t>(sizeof(group)))
+				return false;
+
+			sample = { group.Values[0], group.Values[1], group.Values[2], group.Values[3] };
+			return true;
+		}
+
+	private:
+		std::array<int, 4> Descriptors{ -1, -1, -1, -1 };
+
+		void close()
+		{
+			for (auto& descriptor : Descriptors)
+			{
+				if (descriptor >= 0)
+					::close(descriptor);
+				descriptor = -1;
+			}
+		}
+	};
+
+	const ThreadCounters& getThreadCounters()
+	{
+		thread_local const ThreadCounters counters;
+		return counters;
+	}
+#endif
+}
+
+const char* toString(PerfPhase phase)
+{
+	switch (phase)
+	{
+	case PerfPhase::ProjectileUpdate: return "projectile update";
+	case PerfPhase::Collision: return "collision";
+	case PerfPhase::Draw: return "draw";
+	}
+	return "unknown";
+}
+
+bool arePerfCountersAvailable()
+{
+#if SOMEGAME_PERF_COUNTERS
+	return getThreadCounters().isOpen();
+#else
+	return false;
+#endif
+}
+
+PerfTotals takePerfTotals()
+{
+	PerfTotals totals{};
+	for (std::size_t phase = 0; phase < perfPhaseCount; phase++)
+	{
+		auto& source = phaseTotals[phase];
+		totals[phase] = {
+			source.Cycles.exchange(0, std::memory_order_relaxed),
+			source.Instructions.exchange(0, std::memory_order_relaxed),
+			source.CacheMisses.exchange(0, std::memory_order_relaxed),
+			source.BranchMisses.exchange(0, std::memory_order_relaxed)
+		};
+	}
+	return totals;
+}
+
+void tracePerfTotals(const PerfTotals& totals)
+{
+	const auto timestamp = getTraceTimestamp();
+	for (std::size_t phase = 0; phase < perfPhaseCount; phase++)
+	{
+		const auto& sample = totals[phase];
+		const auto& names = perfTrackNames[phase];
+		recordTraceCounter(names.InstructionsPerCycle, timestamp, sample.getInstructionsPerCycle());
+		recordTraceCounter(names.Instructions, timestamp, static_cast<double>(sample.Instructions));
+		recordTraceCounter(names.CacheMisses, timestamp, static_cast<double>(sample.CacheMisses));
+		recordTraceCounter(names.BranchMisses, timestamp, static_cast<double>(sample.BranchMisses));
+	}
+}
+
+std::string formatPerfTotals(const PerfTotals& totals, std::size_t frames)
+{
+	const auto perFrame = [&](std::uint64_t value)
+	{
+		return static_cast<double>(value) / static_cast<double>(frames == 0 ? 1 : frames);
+	};
+
+	std::string text;
+	for (const auto phase : perfPhases)
+	{
+		const auto& sample = totals[static_cast<std::size_t>(phase)];
+		char line[160];
+		std::snprintf(line, sizeof(line), "%-18s IPC %4.2f  instr %8.0f  cache miss %7.0f  branch miss %7.0f\n",
+			toString(phase),
+			sample.getInstructionsPerCycle(),
+			perFrame(sample.Instructions),
+			perFrame(sample.CacheMisses),
+			perFrame(sample.BranchMisses));
+		text += line;
+	}
+	return text;
+}
+
+#if SOMEGAME_PERF_COUNTERS
+
+PerfScope::PerfScope(PerfPhase phase)
+	: Phase(phase)
+{
+	Active = getThreadCounters().isOpen() && getThreadCounters().read(Start);
+}
+
+PerfScope::~PerfScope()
+{
+	PerfSample end{};
+	if (!Active || !getThreadCounters().read(end))
+		return;
+
+	auto& totals = phaseTotals[static_cast<std::size_t>(Phase)];
+	totals.Cycles.fetch_add(end.Cycles - Start.Cycles, std::memory_order_relaxed);
+	totals.Instructions.fetch_add(end.Instructions - Start.Instructions, std::memory_order_relaxed);
+	totals.CacheMisses.fetch_add(end.CacheMisses - Start.CacheMisses, std::memory_order_relaxed);
+	totals.BranchMisses.fetch_add(end.BranchMisses - Start.BranchMisses, std::memory_order_relaxed);
+}
+
+#endif
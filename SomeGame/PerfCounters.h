@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Hardware counters (cycles, instructions, cache misses, branch misses) per
+// frame phase, read through perf_event_open on Linux:
+//	{
+//		PERF_SCOPE(PerfPhase::Collision);
+//		...
+//	}
+// adds what the calling thread spent inside the scope to the phase's totals.
+// Scopes on several threads add up. takePerfTotals() hands out the totals
+// since its last call, once per frame.
+// Every thread opens its own counters on first use. Where that fails
+// (another OS, no permission, a VM without a PMU) scopes do nothing and
+// arePerfCountersAvailable() is false.
+//
+// Build with SOMEGAME_PERF_COUNTERS=0 to compile every scope out.
+
+#ifndef SOMEGAME_PERF_COUNTERS
+#if defined(__linux__)
+#define SOMEGAME_PERF_COUNTERS 1
+#else
+#define SOMEGAME_PERF_COUNTERS 0
+#endif
+#endif
+
+enum class PerfPhase
+{
+	ProjectileUpdate,
+	Collision,
+	Draw,
+};
+
+constexpr std::size_t perfPhaseCount = 3;
+
+const char* toString(PerfPhase phase);
+
+struct PerfSample
+{
+	std::uint64_t Cycles{};
+	std::uint64_t Instructions{};
+	std::uint64_t CacheMisses{};
+	std::uint64_t BranchMisses{};
+
+	double getInstructionsPerCycle() const
+	{
+		return Cycles == 0 ? 0.0 : static_cast<double>(Instructions) / static_cast<double>(Cycles);
+	}
+
+	PerfSample& operator+=(const PerfSample& other)
+	{
+		Cycles += other.Cycles;
+		Instructions += other.Instructions;
+		CacheMisses += other.CacheMisses;
+		BranchMisses += other.BranchMisses;
+		return *this;
+	}
+};
+
+using PerfTotals = std::array<PerfSample, perfPhaseCount>;
+
+// Whether the calling thread could open its counters.
+bool arePerfCountersAvailable();
+
+PerfTotals takePerfTotals();
+
+// Adds the totals to the trace as counter tracks, one per phase and counter.
+void tracePerfTotals(const PerfTotals& totals);
+
+// One overlay line per phase with the totals averaged over frames.
+std::string formatPerfTotals(const PerfTotals& totals, std::size_t frames);
+
+#if SOMEGAME_PERF_COUNTERS
+
+class PerfScope
+{
+public:
+	explicit PerfScope(PerfPhase phase);
+	~PerfScope();
+
+	PerfScope(const PerfScope&) = delete;
+	PerfScope& operator=(const PerfScope&) = delete;
+
+private:
+	PerfPhase Phase;
+	PerfSample Start{};
+	bool Active{};
+};
+
+#define SOMEGAME_PERF_CONCAT_INNER(a, b) a##b
+#define SOMEGAME_PERF_CONCAT(a, b) SOMEGAME_PERF_CONCAT_INNER(a, b)
+#define PERF_SCOPE(phase) const PerfScope SOMEGAME_PERF_CONCAT(perfScope, __LINE__){ phase }
+
+#else
+
+#define PERF_SCOPE(phase) ((void)0)
+
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include <SFML/System/Vector2.hpp>
+
+#include "Vector2fExtensions.h"
+
+namespace ProjectileFlags
+{
+	// Hit something, left the window or outlived its lifetime, released at
+	// the end of the update.
+	constexpr std::uint8_t Expired = 1 << 0;
+	// Hit an enemy this step. Projectiles that only left the window still
+	// get swept against the enemies they crossed on the way out.
+	constexpr std::uint8_t Hit = 1 << 1;
+}
+
+enum class TargetMode
+{
+	StopAtTarget, // comes to rest on the target position
+	FlyThrough,   // keeps going until it leaves the window or hits something
+};
+
+constexpr float neverReachesTarget = std::numeric_limits<float>::infinity();
+
+struct FixedMovement
+{
+	sf::Vector2f Velocity{};
+	float TimeToTarget = neverReachesTarget;
+
+	// The direction towards the target never changes for a fixed shot, so it's
+	// resolved here once instead of calling angle() and building a polar vector
+	// every frame. Stopping is expressed as the time left until the target is
+	// reached, which the integration kernel clamps each step to.
+	FixedMovement(
+		sf::Vector2f position,
+		sf::Vector2f targetPosition,
+		float speed,
+		TargetMode targetMode)
+	{
+		const auto difference = targetPosition - position;
+		const auto distance = std::sqrt(difference.lengthSquared());
+		if (distance == 0.f || speed <= 0.f)
+		{
+			TimeToTarget = 0.f;
+			return;
+		}
+
+		Velocity = difference * (speed / distance);
+		if (targetMode == TargetMode::StopAtTarget)
+			TimeToTarget = distance / speed;
+	}
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+#include "JobSystem.h"
+#include "MovementModels.h"
+#include "PerfCounters.h"
+#include "ProjectilePool.h"
+
+template <typename Movement>
+struct ProjectileBucket
+{
+	ProjectilePool Projectiles;
+	Movement Model{};
+
+	ProjectileBucket(std::size_t capacity, Movement model)
+		: Projectiles(capacity), Model(model)
+	{
+	}
+
+	// Runs the model over chunks of chunkSize projectiles on all of the job
+	// system's threads.
+	void update(JobSystem& jobs, std::size_t chunkSize, float deltaSeconds, const MovementContext& context)
+	{
+		jobs.parallelFor(Projectiles.size(), chunkSize, [&](std::size_t first, std::size_t count)
+		{
+			PERF_SCOPE(PerfPhase::ProjectileUpdate);
+			const auto projectiles = Projectiles.getSpan(first, count);
+			projectiles.storePreviousPositions();
+			Model.update(projectiles, deltaSeconds, context);
+		});
+	}
+};
+
+// One projectile pool per movement model, resolved at compile time.
+// Updating walks the buckets with a fold expression, so every model gets its
+// own monomorphic loop over its own columns and nothing dispatches per
+// projectile. Buckets are addressed by type, or by index when the choice
+// comes from runtime input such as the selected weapon.
+template <typename... Movements>
+class ProjectileBuckets
+{
+public:
+	static constexpr std::size_t bucketCount = sizeof...(Movements);
+
+	explicit ProjectileBuckets(std::size_t capacityPerBucket)
+		: ProjectileBuckets(capacityPerBucket, Movements{}...)
+	{
+	}
+
+	ProjectileBuckets(std::size_t capacityPerBucket, Movements... models)
+		: Buckets{ ProjectileBucket<Movements>{ capacityPerBucket, models }... }
+	{
+	}
+
+	template <typename Movement>
+	ProjectileBucket<Movement>& get() { return std::get<ProjectileBucket<Movement>>(Buckets); }
+
+	// Calls function(bucket) for every bucket, in declaration order.
+	template <typename Function>
+	void forEach(Function&& function)
+	{
+		std::apply([&](auto&... buckets) { (function(buckets), ...); }, Buckets);
+	}
+
+	template <typename Function>
+	void forEach(Function&& function) const
+	{
+		std::apply([&](const auto&... buckets) { (function(buckets), ...); }, Buckets);
+	}
+
+	// Returns false when bucketIndex is out of range or that bucket is full.
+	bool spawn(std::size_t bucketIndex, sf::Vector2f position, const FixedMovement& movement, float radius, float delaySeconds = 0.f)
+	{
+		return spawnAt(bucketIndex, position, movement, radius, delaySeconds, std::index_sequence_for<Movements...>{});
+	}
+
+	void releaseExpired()
+	{
+		forEach([](auto& bucket) { bucket.Projectiles.releaseExpired(); });
+	}
+
+	std::size_t size() const
+	{
+		std::size_t total = 0;
+		forEach([&](const auto& bucket) { total += bucket.Projectiles.size(); });
+		return total;
+	}
+
+private:
+	std::tuple<ProjectileBucket<Movements>...> Buckets;
+
+	template <std::size_t... Indices>
+	bool spawnAt(
+		std::size_t bucketIndex,
+		sf::Vector2f position,
+		const FixedMovement& movement,
+		float radius,
+		float delaySeconds,
+		std::index_sequence<Indices...>)
+	{
+		bool spawned = false;
+		((Indices == bucketIndex
+			&& (spawned = std::get<Indices>(Buckets).Projectiles.spawn(position, movement, radius, delaySeconds))), ...);
+		return spawned;
+	}
+};
@@ -0,0 +1,218 @@
+#include "ProjectileKernels.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "Simd.h"
+
+namespace
+{
+	void markOutOfBounds(std::uint8_t* flags, std::size_t first, unsigned int mask)
+	{
+		while (mask != 0)
+		{
+			flags[first + std::countr_zero(mask)] |= ProjectileFlags::Expired;
+			mask &= mask - 1;
+		}
+	}
+
+	void integrateScalar(
+		float* x, float* y,
+		const float* velocityX, const float* velocityY,
+		float* timeToTarget,
+		float* age,
+		std::uint8_t* flags,
+		std::size_t first, std::size_t count,
+		float deltaSeconds,
+		sf::Vector2f bounds)
+	{
+		for (auto i = first; i < count; i++)
+		{
+			const auto step = std::min(deltaSeconds, timeToTarget[i]);
+			x[i] += velocityX[i] * step;
+			y[i] += velocityY[i] * step;
+			timeToTarget[i] -= step;
+			age[i] += deltaSeconds;
+
+			if (sf::Vector2fExtensions::isOutOfBounds({ x[i], y[i] }, bounds))
+				flags[i] |= ProjectileFlags::Expired;
+		}
+	}
+
+#if SOMEGAME_X86
+	SOMEGAME_TARGET_SSE2
+	void integrateSse2(
+		float* x, float* y,
+		const float* velocityX, const float* velocityY,
+		float* timeToTarget,
+		float* age,
+		std::uint8_t* flags,
+		std::size_t count,
+		float deltaSeconds,
+		sf::Vector2f bounds)
+	{
+		const auto dt = _mm_set1_ps(deltaSeconds);
+		const auto zero = _mm_setzero_ps();
+		const auto maxX = _mm_set1_ps(bounds.x);
+		const auto maxY = _mm_set1_ps(bounds.y);
+
+		std::size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const auto remaining = _mm_loadu_ps(timeToTarget + i);
+			const auto step = _mm_min_ps(dt, remaining);
+			const auto px = _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(_mm_loadu_ps(velocityX + i), step));
+			const auto py = _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(_mm_loadu_ps(velocityY + i), step));
+			_mm_storeu_ps(x + i, px);
+			_mm_storeu_ps(y + i, py);
+			_mm_storeu_ps(timeToTarget + i, _mm_sub_ps(remaining, step));
+			_mm_storeu_ps(age + i, _mm_add_ps(_mm_loadu_ps(age + i), dt));
+
+			const auto outside = _mm_or_ps(
+				_mm_or_ps(_mm_cmplt_ps(px, zero), _mm_cmpgt_ps(px, maxX)),
+				_mm_or_ps(_mm_cmplt_ps(py, zero), _mm_cmpgt_ps(py, maxY)));
+			markOutOfBounds(flags, i, static_cast<unsigned int>(_mm_movemask_ps(outside)));
+		}
+
+		integrateScalar(x, y, velocityX, velocityY, timeToTarget, age, flags, i, count, deltaSeconds, bounds);
+	}
+
+	SOMEGAME_TARGET_AVX2
+	void integrateAvx2(
+		float* x, float* y,
+		const float* velocityX, const float* velocityY,
+		float* timeToTarget,
+		float* age,
+		std::uint8_t* flags,
+		std::size_t count,
+		float deltaSeconds,
+		sf::Vector2f bounds)
+	{
+		const auto dt = _mm256_set1_ps(deltaSeconds);
+		const auto zero = _mm256_setzero_ps();
+		const auto maxX = _mm256_set1_ps(bounds.x);
+		const auto maxY = _mm256_set1_ps(bounds.y);
+
+		std::size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const auto remaining = _mm256_loadu_ps(timeToTarget + i);
+			const auto step = _mm256_min_ps(dt, remaining);
+			const auto px = _mm256_fmadd_ps(_mm256_loadu_ps(velocityX + i), step, _mm256_loadu_ps(x + i));
+			const auto py = _mm256_fmadd_ps(_mm256_loadu_ps(velocityY + i), step, _mm256_loadu_ps(y + i));
+			_mm256_storeu_ps(x + i, px);
+			_mm256_storeu_ps(y + i, py);
+			_mm256_storeu_ps(timeToTarget + i, _mm256_sub_ps(remaining, step));
+			_mm256_storeu_ps(age + i, _mm256_add_ps(_mm256_loadu_ps(age + i), dt));
+
+			const auto outside = _mm256_or_ps(
+				_mm256_or_ps(_mm256_cmp_ps(px, zero, _CMP_LT_OQ), _mm256_cmp_ps(px, maxX, _CMP_GT_OQ)),
+				_mm256_or_ps(_mm256_cmp_ps(py, zero, _CMP_LT_OQ), _mm256_cmp_ps(py, maxY, _CMP_GT_OQ)));
+			markOutOfBounds(flags, i, static_cast<unsigned int>(_mm256_movemask_ps(outside)));
+		}
+
+		// GCC doesn't clear the upper ymm halves in target("avx2") functions;
+		// without this every SSE instruction after the kernel pays a transition.
+		_mm256_zeroupper();
+		integrateScalar(x, y, velocityX, velocityY, timeToTarget, age, flags, i, count, deltaSeconds, bounds);
+	}
+
+	bool cpuSupportsAvx2()
+	{
+#if defined(_MSC_VER)
+		int info[4]{};
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return false;
+
+		__cpuid(info, 1);
+		const bool hasFma = (info[2] & (1 << 12)) != 0;
+		const bool hasOsxsave = (info[2] & (1 << 27)) != 0;
+		if (!hasFma || !hasOsxsave)
+			return false;
+
+		// The OS has to save the upper halves of the ymm registers on context switches.
+		if ((_xgetbv(0) & 0x6) != 0x6)
+			return false;
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+	}
+#endif
+
+	KernelLevel detectKernelLevelUncached()
+	{
+#if SOMEGAME_X86
+		if (cpuSupportsAvx2())
+			return KernelLevel::Avx2;
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		return KernelLevel::Sse2;
+#endif
+#endif
+		return KernelLevel::Scalar;
+	}
+}
+
+KernelLevel detectKernelLevel()
+{
+	static const KernelLevel level = detectKernelLevelUncached();
+	return level;
+}
+
+const char* toString(KernelLevel level)
+{
+	switch (level)
+	{
+	case KernelLevel::Scalar:
+		return "scalar";
+	case KernelLevel::Sse2:
+		return "sse2";
+	case KernelLevel::Avx2:
+		return "avx2";
+	}
+	return "unknown";
+}
+
+void integrateProjectiles(
+	float* x, float* y,
+	const float* velocityX, const float* velocityY,
+	float* timeToTarget,
+	float* age,
+	std::uint8_t* flags,
+	std::size_t count,
+	float deltaSeconds,
+	sf::Vector2f bounds)
+{
+	integrateProjectiles(x, y, velocityX, velocityY, timeToTarget, age, flags, count, deltaSeconds, bounds, detectKernelLevel());
+}
+
+void integrateProjectiles(
+	float* x, float* y,
+	const float* velocityX, const float* velocityY,
+	float* timeToTarget,
+	float* age,
+	std::uint8_t* flags,
+	std::size_t count,
+	float deltaSeconds,
+	sf::Vector2f bounds,
+	KernelLevel level)
+{
+	switch (level)
+	{
+#if SOMEGAME_X86
+	case KernelLevel::Avx2:
+		integrateAvx2(x, y, velocityX, velocityY, timeToTarget, age, flags, count, deltaSeconds, bounds);
+		return;
+	case KernelLevel::Sse2:
+		integrateSse2(x, y, velocityX, velocityY, timeToTarget, age, flags, count, deltaSeconds, bounds);
+		return;
+#endif
+	default:
+		integrateScalar(x, y, velocityX, velocityY, timeToTarget, age, flags, 0, count, deltaSeconds, bounds);
+		return;
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <SFML/System/Vector2.hpp>
+
+#include "ProjectilePool.h"
+
+enum class KernelLevel
+{
+	Scalar,
+	Sse2,
+	Avx2,
+};
+
+// Best instruction set this CPU and OS support, detected once on first call.
+KernelLevel detectKernelLevel();
+const char* toString(KernelLevel level);
+
+// Moves every projectile by velocity * min(deltaSeconds, timeToTarget), so
+// stopping projectiles come to rest on their target, advances its age, and in
+// the same pass sets ProjectileFlags::Expired on the ones that ended up
+// outside of bounds.
+// The level overload forces a specific implementation and is meant for
+// benchmarks; asking for a level above detectKernelLevel() is undefined.
+void integrateProjectiles(
+	float* x, float* y,
+	const float* velocityX, const float* velocityY,
+	float* timeToTarget,
+	float* age,
+	std::uint8_t* flags,
+	std::size_t count,
+	float deltaSeconds,
+	sf::Vector2f bounds);
+
+void integrateProjectiles(
+	float* x, float* y,
+	const float* velocityX, const float* velocityY,
+	float* timeToTarget,
+	float* age,
+	std::uint8_t* flags,
+	std::size_t count,
+	float deltaSeconds,
+	sf::Vector2f bounds,
+	KernelLevel level);
+
+inline void integrateProjectiles(
+	const ProjectileSpan& projectiles,
+	float deltaSeconds,
+	sf::Vector2f bounds,
+	KernelLevel level = detectKernelLevel())
+{
+	integrateProjectiles(
+		projectiles.X, projectiles.Y,
+		projectiles.VelocityX, projectiles.VelocityY,
+		projectiles.TimeToTarget,
+		projectiles.Age,
+		projectiles.Flags,
+		projectiles.Count,
+		deltaSeconds,
+		bounds,
+		level);
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <SFML/System/Vector2.hpp>
+
+#include "Projectile.h"
+
+// The columns of a run of projectiles in a pool. Movement models work on
+// spans, so a pool can be updated in chunks on several threads. A span is
+// only valid until the pool's next spawn or release.
+struct ProjectileSpan
+{
+	float* X{};
+	float* Y{};
+	float* PreviousX{};
+	float* PreviousY{};
+	float* VelocityX{};
+	float* VelocityY{};
+	float* Radius{};
+	float* TimeToTarget{};
+	float* Age{};
+	std::uint8_t* Flags{};
+	std::size_t Count{};
+
+	// Called at the start of every simulation step, before anything moves.
+	void storePreviousPositions() const
+	{
+		std::copy_n(X, Count, PreviousX);
+		std::copy_n(Y, Count, PreviousY);
+	}
+};
+
+// Fixed-capacity structure-of-arrays storage for live projectiles.
+// Every column is allocated up front, so spawning never allocates, and the
+// update loop only streams through the columns it actually reads. Removal
+// swaps the last projectile into the freed slot instead of shifting the tail.
+// There is no shape per projectile; the renderer builds one when drawing.
+class ProjectilePool
+{
+public:
+	std::vector<float> X;
+	std::vector<float> Y;
+	std::vector<float> PreviousX; // position at the start of the last step, for render interpolation
+	std::vector<float> PreviousY;
+	std::vector<float> VelocityX;
+	std::vector<float> VelocityY;
+	std::vector<float> Radius;
+	std::vector<float> TimeToTarget;
+	std::vector<float> Age;
+	std::vector<std::uint8_t> Flags;
+
+	explicit ProjectilePool(std::size_t capacity)
+		: X(capacity), Y(capacity),
+		PreviousX(capacity), PreviousY(capacity),
+		VelocityX(capacity), VelocityY(capacity),
+		Radius(capacity),
+		TimeToTarget(capacity),
+		Age(capacity),
+		Flags(capacity)
+	{
+	}
+
+	// Returns false when the pool is full and the projectile was dropped.
+	// delaySeconds is how far into the coming update the projectile is fired:
+	// it's placed that far back along its path, so the update only moves it
+	// for the rest of the step and it comes out where it would have been.
+	bool spawn(sf::Vector2f position, const FixedMovement& movement, float radius, float delaySeconds = 0.f)
+	{
+		if (Count >= capacity())
+			return false;
+
+		const auto index = Count++;
+		X[index] = position.x - movement.Velocity.x * delaySeconds;
+		Y[index] = position.y - movement.Velocity.y * delaySeconds;
+		PreviousX[index] = X[index];
+		PreviousY[index] = Y[index];
+		VelocityX[index] = movement.Velocity.x;
+		VelocityY[index] = movement.Velocity.y;
+		Radius[index] = radius;
+		TimeToTarget[index] = movement.TimeToTarget + delaySeconds;
+		Age[index] = -delaySeconds;
+		Flags[index] = 0;
+		return true;
+	}
+
+	// Appends up to count projectiles, as many as still fit, and returns a
+	// span over them for the caller to write every column of but Flags,
+	// which starts cleared. For spawning whole volleys at once.
+	ProjectileSpan spawnSpan(std::size_t count)
+	{
+		const auto first = Count;
+		Count += std::min(count, capacity() - Count);
+		std::fill(Flags.begin() + static_cast<std::ptrdiff_t>(first), Flags.begin() + static_cast<std::ptrdiff_t>(Count), std::uint8_t{});
+		return getSpan(first, Count - first);
+	}
+
+	// Removes the projectile at index by moving the last one into its slot.
+	// When iterating, don't advance past index after a release: the slot now
+	// holds a projectile that hasn't been visited yet.
+	void release(std::size_t index)
+	{
+		assert(index < Count);
+
+		const auto last = --Count;
+		if (index == last)
+			return;
+
+		X[index] = X[last];
+		Y[index] = Y[last];
+		PreviousX[index] = PreviousX[last];
+		PreviousY[index] = PreviousY[last];
+		VelocityX[index] = VelocityX[last];
+		VelocityY[index] = VelocityY[last];
+		Radius[index] = Radius[last];
+		TimeToTarget[index] = TimeToTarget[last];
+		Age[index] = Age[last];
+		Flags[index] = Flags[last];
+	}
+
+	// Releases every projectile flagged as Expired during the update.
+	void releaseExpired()
+	{
+		for (std::size_t i = 0; i < Count;)
+		{
+			if (Flags[i] & ProjectileFlags::Expired)
+			{
+				release(i);
+				continue;
+			}
+			++i;
+		}
+	}
+
+	// count projectiles from first on, clamped to the live ones.
+	ProjectileSpan getSpan(std::size_t first, std::size_t count)
+	{
+		first = std::min(first, Count);
+		count = std::min(count, Count - first);
+		return {
+			X.data() + first, Y.data() + first,
+			PreviousX.data() + first, PreviousY.data() + first,
+			VelocityX.data() + first, VelocityY.data() + first,
+			Radius.data() + first,
+			TimeToTarget.data() + first,
+			Age.data() + first,
+			Flags.data() + first,
+			count
+		};
+	}
+
+	ProjectileSpan getSpan() { return getSpan(0, Count); }
+
+	sf::Vector2f getPosition(std::size_t index) const { return { X[index], Y[index] }; }
+
+	// Position between the previous and the current step, alpha in [0, 1].
+	sf::Vector2f getInterpolatedPosition(std::size_t index, float alpha) const
+	{
+		return {
+			PreviousX[index] + (X[index] - PreviousX[index]) * alpha,
+			PreviousY[index] + (Y[index] - PreviousY[index]) * alpha
+		};
+	}
+
+	void clear() { Count = 0; }
+
+	std::size_t size() const { return Count; }
+	std::size_t capacity() const { return Flags.size(); }
+	bool empty() const { return Count == 0; }
+	bool full() const { return Count >= capacity(); }
+
+private:
+	std::size_t Count{};
+};
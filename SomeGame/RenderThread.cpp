@@ -0,0 +1,102 @@
+#include "RenderThread.h"
+
+#include <string>
+
+#include "Log.h"
+#include "PerfCounters.h"
+#include "Systems.h"
+#include "Trace.h"
+
+void RenderSnapshot::extract(const Simulation& simulation, float interpolation, JobSystem& jobs)
+{
+	Players.clear();
+	extractCircles(simulation.Players, interpolation, Players);
+
+	Projectiles.clear();
+	simulation.Projectiles.forEach([&](const auto& bucket) { Projectiles.append(bucket.Projectiles, sf::Color::White, interpolation, jobs); });
+
+	EnemyProjectiles.clear();
+	EnemyProjectiles.append(simulation.EnemyProjectiles.Projectiles, sf::Color::Yellow, interpolation, jobs);
+
+	Enemies.clear();
+	extractCircles(simulation.Enemies, interpolation, Enemies);
+}
+
+RenderThread::RenderThread(sf::RenderWindow& window)
+	: Window(window), Font("resources/fonts/Caliban.ttf")
+{
+	// A context can only be active on one thread at a time.
+	(void)Window.setActive(false);
+
+	Thread = std::jthread([this] { run(); });
+}
+
+RenderThread::~RenderThread()
+{
+	stop();
+}
+
+RenderSnapshot* RenderThread::getSnapshot()
+{
+	TRACE_ZONE("wait for render thread");
+	if (!Snapshots.waitUntilTaken())
+		return nullptr;
+	return &Snapshots.getWriteBuffer();
+}
+
+void RenderThread::publish()
+{
+	Snapshots.publish();
+}
+
+void RenderThread::stop()
+{
+	Snapshots.stop();
+	if (Thread.joinable())
+		Thread.join();
+}
+
+void RenderThread::run()
+{
+	setTraceThreadName("render");
+	if (!Window.setActive(true))
+	{
+		// Without this the main thread would wait for a consumer that is gone.
+		LOG_ERROR("The render thread can't activate the window's OpenGL context");
+		Snapshots.stop();
+		return;
+	}
+
+	sf::Text text(Font, "", 14);
+	text.setFillColor(sf::Color::White);
+	text.setPosition(sf::Vector2f{ 10.f, 10.f });
+	std::string shownText;
+
+	while (const auto* snapshot = Snapshots.acquire())
+	{
+		// Only lay the text out again when it changed.
+		if (snapshot->TimingText != shownText)
+		{
+			shownText = snapshot->TimingText;
+			text.setString(shownText);
+		}
+
+		{
+			TRACE_ZONE("draw");
+			PERF_SCOPE(PerfPhase::Draw);
+			Window.clear(sf::Color::Black);
+			Window.draw(snapshot->Players);
+			Window.draw(snapshot->Projectiles);
+			Window.draw(snapshot->EnemyProjectiles);
+			Window.draw(snapshot->Enemies);
+			Window.draw(snapshot->TimingGraph);
+			Window.draw(text);
+		}
+		{
+			TRACE_ZONE("display");
+			Window.display();
+		}
+	}
+
+	(void)Window.setActive(false);
+}
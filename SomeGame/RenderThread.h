@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <thread>
+
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/Graphics/Text.hpp>
+
+#include "CircleRenderer.h"
+#include "FrameTimeGraph.h"
+#include "JobSystem.h"
+#include "Simulation.h"
+#include "TripleBuffer.h"
+
+// Everything the render thread draws for one frame, already in vertices.
+struct RenderSnapshot
+{
+	CircleRenderer Players{ 32 };
+	CircleRenderer Projectiles{};
+	CircleRenderer EnemyProjectiles{};
+	CircleRenderer Enemies{ 32 };
+	std::string TimingText{};
+	FrameTimeGraph TimingGraph{ { { 10.f, windowHeight - 110.f }, { 300.f, 100.f } }, 50.f };
+
+	// Replaces the contents with the simulation blended interpolation of
+	// the way from its previous to its current step.
+	void extract(const Simulation& simulation, float interpolation, JobSystem& jobs);
+};
+
+// Draws snapshots on a thread of its own, so the main thread can step the
+// simulation for the next frame while this one is drawn and display() waits
+// for the swap. The render thread owns the window's OpenGL context; the main
+// thread keeps handling the window's events.
+// The main thread fills getSnapshot() and then calls publish().
+class RenderThread
+{
+public:
+	explicit RenderThread(sf::RenderWindow& window);
+	~RenderThread();
+
+	RenderThread(const RenderThread&) = delete;
+	RenderThread& operator=(const RenderThread&) = delete;
+
+	// Waits until the render thread has picked up the last snapshot, then
+	// returns the one to fill next. Returns nullptr once the render thread
+	// has stopped, also when it couldn't take the window's context.
+	RenderSnapshot* getSnapshot();
+	void publish();
+
+	// Returns once the render thread has finished its last frame and released
+	// the context. Call before closing the window.
+	void stop();
+
+private:
+	sf::RenderWindow& Window;
+	sf::Font Font;
+	TripleBuffer<RenderSnapshot> Snapshots;
+	std::jthread Thread;
+
+	void run();
+};
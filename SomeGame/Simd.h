@@ -0,0 +1,24 @@
+#pragma once
+
+// Instruction set plumbing shared by the SIMD kernels. Only include this
+// from .cpp files: it pulls in the intrinsics headers.
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SOMEGAME_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define SOMEGAME_X86 0
+#endif
+
+// MSVC lets any function use any intrinsic, GCC and Clang need the target
+// enabled per function so the rest of the binary stays baseline x86-64.
+#if SOMEGAME_X86 && (defined(__GNUC__) || defined(__clang__))
+#define SOMEGAME_TARGET_SSE2 __attribute__((target("sse2")))
+#define SOMEGAME_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#else
+#define SOMEGAME_TARGET_SSE2
+#define SOMEGAME_TARGET_AVX2
+#endif
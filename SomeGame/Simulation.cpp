@@ -0,0 +1,282 @@
+#include "Simulation.h"
+
+#include <SFML/Graphics/Color.hpp>
+
+#include "PerfCounters.h"
+#include "Systems.h"
+#include "Trace.h"
+#include "Vector2fExtensions.h"
+
+Simulation::Simulation(JobSystem& jobs)
+	: Jobs(jobs)
+{
+	const sf::Vector2f playerCenter{ playerRadius, playerRadius };
+	Players.spawn(
+		CircleCollider{ playerCenter, playerRadius },
+		PreviousCenter{ playerCenter },
+		Appearance{ sf::Color::Blue },
+		CenterMarker{ playerRadius / 100 * 10, sf::Color::Red });
+
+	spawnEnemy(sf::Vector2f{ 400.f + enemyRadius, 400.f + enemyRadius });
+
+	buildStepGraph();
+}
+
+std::optional<Entity> Simulation::spawnEnemy(sf::Vector2f center)
+{
+	return Enemies.spawn(
+		CircleCollider{ center, enemyRadius },
+		PreviousCenter{ center },
+		Appearance{ sf::Color::Red },
+		Health{ enemyHp },
+		Patrol{});
+}
+
+void Simulation::step(float deltaSeconds, const InputState& input)
+{
+	if (input.SelectMovement && *input.SelectMovement < PlayerProjectiles::bucketCount)
+		SelectedMovement = *input.SelectMovement;
+
+	TRACE_ZONE("step");
+
+	StepSeconds = deltaSeconds;
+	StepInput = &input;
+	Jobs.run(StepGraph);
+	StepInput = nullptr;
+
+	Stats.Steps++;
+}
+
+std::size_t Simulation::getProjectileCount() const
+{
+	return Projectiles.size() + EnemyProjectiles.Projectiles.size();
+}
+
+std::uint64_t Simulation::computeChecksum() const
+{
+	// FNV-1a over the bytes of every value that steps carry forward.
+	std::uint64_t hash = 14695981039346656037ull;
+	const auto add = [&](const auto& value)
+	{
+		const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+		for (std::size_t i = 0; i < sizeof(value); i++)
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+	};
+	const auto addCircles = [&](const auto& archetype)
+	{
+		add(archetype.size());
+		archetype.template forEach<CircleCollider>([&](const CircleCollider& body)
+		{
+			add(body.getCenter().x);
+			add(body.getCenter().y);
+		});
+	};
+
+	addCircles(Players);
+	addCircles(Enemies);
+	Enemies.forEach<Health, Patrol>([&](const Health& health, const Patrol& patrol)
+	{
+		add(health.Hp);
+		add(patrol.IsPathingDown);
+	});
+
+	Projectiles.forEach([&](const auto& bucket)
+	{
+		const auto& pool = bucket.Projectiles;
+		add(pool.size());
+		for (std::size_t i = 0; i < pool.size(); i++)
+		{
+			add(pool.X[i]);
+			add(pool.Y[i]);
+			add(pool.VelocityX[i]);
+			add(pool.VelocityY[i]);
+			add(pool.TimeToTarget[i]);
+			add(pool.Age[i]);
+		}
+	});
+
+	add(EnemyProjectiles.Projectiles.size());
+	for (std::size_t i = 0; i < EnemyProjectiles.Projectiles.size(); i++)
+	{
+		add(EnemyProjectiles.Projectiles.X[i]);
+		add(EnemyProjectiles.Projectiles.Y[i]);
+		add(EnemyProjectiles.Projectiles.Age[i]);
+	}
+
+	add(SelectedMovement);
+	add(PlayerWeapon.getCooldown());
+	for (const auto& pattern : { &PlayerPattern, &EnemyPattern })
+	{
+		if (*pattern)
+		{
+			add((*pattern)->getPhase());
+			add((*pattern)->getCooldown());
+		}
+	}
+	add(Stats.ProjectilesFired);
+	add(Stats.EnemyHits);
+	add(Stats.EnemyProjectilesFired);
+	return hash;
+}
+
+void Simulation::buildStepGraph()
+{
+	const auto storePrevious = StepGraph.addJob([this]
+	{
+		TRACE_ZONE("store previous centers");
+		storePreviousCenters(Players);
+		storePreviousCenters(Enemies);
+	});
+	const auto patrol = StepGraph.addJob([this]
+	{
+		TRACE_ZONE("patrol enemies");
+		patrolEnemies(Jobs, Enemies, StepSeconds);
+	});
+	const auto player = StepGraph.addJob([this]
+	{
+		TRACE_ZONE("update player");
+		updatePlayer(StepSeconds, *StepInput);
+	});
+	const auto homingTarget = StepGraph.addJob([this]
+	{
+		TRACE_ZONE("select homing target");
+		selectHomingTarget();
+	});
+	const auto collisions = StepGraph.addJob([this]
+	{
+		TRACE_ZONE("collisions");
+		resolveCollisions();
+	});
+
+	// Enemies fire from where they moved to, at where the player moved to,
+	// and before collisions can despawn any of them.
+	const auto enemyFire = StepGraph.addJob([this]
+	{
+		TRACE_ZONE("enemy fire");
+		fireEnemyPattern(StepSeconds);
+		EnemyProjectiles.update(Jobs, parallelChunkSize, StepSeconds, MovementContext{ windowSize });
+		expireProjectiles(EnemyProjectiles.Projectiles, projectileLifetime);
+		EnemyProjectiles.Projectiles.releaseExpired();
+	});
+
+	StepGraph.precede(storePrevious, patrol);
+	StepGraph.precede(storePrevious, player);
+	StepGraph.precede(patrol, homingTarget);
+	StepGraph.precede(patrol, enemyFire);
+	StepGraph.precede(player, enemyFire);
+	StepGraph.precede(enemyFire, collisions);
+
+	// Buckets move independently of each other, each in chunks, once the
+	// player has fired and the homing target has moved.
+	Projectiles.forEach([&](auto& bucket)
+	{
+		const auto update = StepGraph.addJob([this, &bucket]
+		{
+			TRACE_ZONE("update projectiles");
+			bucket.update(Jobs, parallelChunkSize, StepSeconds, StepMovementContext);
+			expireProjectiles(bucket.Projectiles, projectileLifetime);
+		});
+		StepGraph.precede(player, update);
+		StepGraph.precede(homingTarget, update);
+		StepGraph.precede(update, collisions);
+	});
+}
+
+void Simulation::updatePlayer(float deltaSeconds, const InputState& input)
+{
+	sf::Vector2f playerMovement = sf::VectorZero;
+	const auto playerVelocity = playerSpeed * deltaSeconds;
+
+	if (input.MoveUp)
+		playerMovement.y -= playerVelocity;
+	if (input.MoveLeft)
+		playerMovement.x -= playerVelocity;
+	if (input.MoveDown)
+		playerMovement.y += playerVelocity;
+	if (input.MoveRight)
+		playerMovement.x += playerVelocity;
+
+	Players.forEach<CircleCollider>([&](CircleCollider& body)
+	{
+		const auto stepStart = body.getCenter();
+		body.move(playerMovement);
+		confineToArea(body, sf::FloatRect{ sf::VectorZero, windowSize });
+		const auto stepEnd = body.getCenter();
+
+		// Each shot leaves from where the player was at that moment of the
+		// step, which is inside the window since both ends are.
+		const auto positionAt = [&](float delaySeconds)
+		{
+			return stepStart + (stepEnd - stepStart) * (delaySeconds / deltaSeconds);
+		};
+
+		if (PlayerPattern)
+		{
+			PlayerPattern->update(deltaSeconds, input.Fire, [&](float delaySeconds)
+			{
+				std::size_t bucketIndex = 0;
+				Projectiles.forEach([&](auto& bucket)
+				{
+					if (bucketIndex++ == SelectedMovement)
+						Stats.ProjectilesFired += PlayerPattern->emit(bucket.Projectiles, positionAt(delaySeconds), input.AimPosition, delaySeconds);
+				});
+			});
+			return;
+		}
+
+		PlayerWeapon.update(deltaSeconds, input.Fire, [&](float delaySeconds)
+		{
+			const auto projectileSpawnPosition = positionAt(delaySeconds);
+			if (input.AimPosition == projectileSpawnPosition)
+				return;
+
+			// Only straight shots stop on the cursor, curved ones would freeze mid-path.
+			const FixedMovement projectileMovement
+			{
+				projectileSpawnPosition,
+				input.AimPosition,
+				projectileSpeed,
+				SelectedMovement == 0 ? projectileTargetMode : TargetMode::FlyThrough
+			};
+			if (Projectiles.spawn(SelectedMovement, projectileSpawnPosition, projectileMovement, projectileRadius, delaySeconds))
+				Stats.ProjectilesFired++;
+		});
+	});
+}
+
+void Simulation::fireEnemyPattern(float deltaSeconds)
+{
+	if (!EnemyPattern || Enemies.empty() || Players.empty())
+		return;
+
+	const auto target = Players.get<CircleCollider>(0).getCenter();
+	EnemyPattern->update(deltaSeconds, true, [&](float delaySeconds)
+	{
+		const auto alpha = delaySeconds / deltaSeconds;
+		Enemies.forEach<CircleCollider, PreviousCenter>([&](const CircleCollider& body, const PreviousCenter& previous)
+		{
+			const auto origin = previous.Value + (body.getCenter() - previous.Value) * alpha;
+			Stats.EnemyProjectilesFired += EnemyPattern->emit(EnemyProjectiles.Projectiles, origin, target, delaySeconds);
+		});
+	});
+}
+
+void Simulation::selectHomingTarget()
+{
+	// Homing projectiles stay on one enemy until it dies, then pick the next.
+	if (!HomingTarget || !Enemies.isAlive(*HomingTarget))
+		HomingTarget = Enemies.empty() ? std::nullopt : std::optional{ Enemies.getEntity(0) };
+
+	StepMovementContext.HomingTarget.reset();
+	if (HomingTarget)
+		StepMovementContext.HomingTarget = Enemies.get<CircleCollider>(*Enemies.indexOf(*HomingTarget)).getCenter();
+}
+
+void Simulation::resolveCollisions()
+{
+	PERF_SCOPE(PerfPhase::Collision);
+	Stats.EnemyHits += collideProjectiles(Projectiles, Enemies, EnemyGrid, ProjectileCollision);
+
+	Enemies.despawnIf([&](std::size_t i) { return Enemies.get<Health>(i).Hp <= 10; });
+	Projectiles.releaseExpired();
+}
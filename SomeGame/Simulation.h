@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include <SFML/System/Vector2.hpp>
+
+#include "BulletPattern.h"
+#include "Components.h"
+#include "Ecs.h"
+#include "GameConfig.h"
+#include "JobSystem.h"
+#include "SpatialGrid.h"
+#include "WeaponEmitter.h"
+
+// Everything the simulation reads from the player for one step. The window
+// fills it from the keyboard and mouse, headless runs from an input script.
+struct InputState
+{
+	bool MoveUp{};
+	bool MoveLeft{};
+	bool MoveDown{};
+	bool MoveRight{};
+	bool Fire{};
+	sf::Vector2f AimPosition{};
+	std::optional<std::size_t> SelectMovement{};
+
+	bool operator==(const InputState&) const = default;
+};
+
+struct SimulationStats
+{
+	std::size_t Steps{};
+	std::size_t ProjectilesFired{};
+	std::size_t EnemyHits{};
+	std::size_t EnemyProjectilesFired{};
+};
+
+// The game state and its per-frame update, without any window or rendering,
+// so it can run on machines with no display. Entities live in archetypes and
+// step() runs the systems over them as a job graph: systems that don't share
+// data run at the same time, and the big ones split into chunks.
+class Simulation
+{
+public:
+	PlayerArchetype Players{ 1 };
+	EnemyArchetype Enemies{ maxEnemies };
+	PlayerProjectiles Projectiles{ maxProjectiles };
+	// Enemy fire only flies, nothing it hits takes damage.
+	ProjectileBucket<LinearMovement> EnemyProjectiles{ maxEnemyProjectiles, {} };
+	std::size_t SelectedMovement = 0;
+	CollisionMode ProjectileCollision = projectileCollisionMode;
+	SimulationStats Stats{};
+	// With a pattern the player fires its volleys into the selected bucket
+	// instead of single shots, and every enemy fires at the player in step.
+	std::optional<PatternEmitter> PlayerPattern{};
+	std::optional<PatternEmitter> EnemyPattern{};
+
+	explicit Simulation(JobSystem& jobs);
+
+	std::optional<Entity> spawnEnemy(sf::Vector2f center);
+	void step(float deltaSeconds, const InputState& input);
+
+	// Player and enemy projectiles in flight.
+	std::size_t getProjectileCount() const;
+
+	// Hash of the whole game state, equal only when two runs ended up in
+	// exactly the same state.
+	std::uint64_t computeChecksum() const;
+
+private:
+	JobSystem& Jobs;
+	JobGraph StepGraph;
+	float StepSeconds{};
+	const InputState* StepInput{};
+	MovementContext StepMovementContext{ windowSize };
+
+	WeaponEmitter PlayerWeapon{ projectileFireInterval };
+	std::optional<Entity> HomingTarget{};
+	SpatialGrid EnemyGrid{ windowSize, collisionCellSize };
+
+	void buildStepGraph();
+	void updatePlayer(float deltaSeconds, const InputState& input);
+	void selectHomingTarget();
+	void fireEnemyPattern(float deltaSeconds);
+	void resolveCollisions();
+};
@@ -0,0 +1,61 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+SpatialGrid::SpatialGrid(sf::Vector2f area, float cellSize)
+	: InverseCellSize(1.f / cellSize),
+	Columns(std::max(1, static_cast<int>(std::ceil(area.x / cellSize)))),
+	Rows(std::max(1, static_cast<int>(std::ceil(area.y / cellSize)))),
+	CellStart(getCellCount() + 1)
+{
+}
+
+void SpatialGrid::clear()
+{
+	Pending.clear();
+}
+
+void SpatialGrid::insert(std::uint32_t id, const sf::FloatRect& bounds)
+{
+	const auto cells = getCellRange(bounds);
+	for (auto cellY = cells.MinY; cellY <= cells.MaxY; cellY++)
+	{
+		for (auto cellX = cells.MinX; cellX <= cells.MaxX; cellX++)
+			Pending.push_back({ static_cast<std::uint32_t>(cellY * Columns + cellX), id });
+	}
+
+	if (id >= VisitedStamp.size())
+		VisitedStamp.resize(static_cast<std::size_t>(id) + 1, QueryStamp);
+}
+
+void SpatialGrid::build()
+{
+	// Counting sort by cell: count, prefix sum, scatter.
+	std::fill(CellStart.begin(), CellStart.end(), 0);
+	for (const auto& pending : Pending)
+		CellStart[pending.Cell + 1]++;
+
+	for (std::size_t cell = 1; cell < CellStart.size(); cell++)
+		CellStart[cell] += CellStart[cell - 1];
+
+	WriteCursor.assign(CellStart.begin(), CellStart.end() - 1);
+	Entries.resize(Pending.size());
+	for (const auto& pending : Pending)
+		Entries[WriteCursor[pending.Cell]++] = pending.Id;
+}
+
+SpatialGrid::CellRange SpatialGrid::getCellRange(const sf::FloatRect& bounds) const
+{
+	const auto toCell = [this](float coordinate, int cellCount)
+	{
+		return std::clamp(static_cast<int>(std::floor(coordinate * InverseCellSize)), 0, cellCount - 1);
+	};
+
+	return {
+		toCell(bounds.position.x, Columns),
+		toCell(bounds.position.y, Rows),
+		toCell(bounds.position.x + bounds.size.x, Columns),
+		toCell(bounds.position.y + bounds.size.y, Rows)
+	};
+}
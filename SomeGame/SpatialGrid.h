@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+// Uniform grid broadphase over a fixed area, rebuilt from scratch each step.
+// insert() every collider, build() once, then query() with anything that
+// needs candidates: only colliders sharing a cell with the query box come
+// back, so narrowphase cost follows local density instead of the total count.
+// Colliders outside the area are clamped into the border cells. Buffers keep
+// their capacity across rebuilds, so steady-state steps don't allocate.
+class SpatialGrid
+{
+public:
+	SpatialGrid(sf::Vector2f area, float cellSize);
+
+	void clear();
+	void insert(std::uint32_t id, const sf::FloatRect& bounds);
+	void build();
+
+	// Calls visit(id) once for every collider whose cells overlap bounds.
+	// Returning true from visit stops the query early.
+	template <typename Visit>
+	void query(const sf::FloatRect& bounds, Visit&& visit) const
+	{
+		const auto cells = getCellRange(bounds);
+		const bool multipleCells = cells.MinX != cells.MaxX || cells.MinY != cells.MaxY;
+		if (multipleCells && ++QueryStamp == 0)
+		{
+			// Wrapped around: stamps left from long ago could match again.
+			std::fill(VisitedStamp.begin(), VisitedStamp.end(), 0);
+			QueryStamp = 1;
+		}
+
+		for (auto cellY = cells.MinY; cellY <= cells.MaxY; cellY++)
+		{
+			for (auto cellX = cells.MinX; cellX <= cells.MaxX; cellX++)
+			{
+				const auto cell = cellY * Columns + cellX;
+				for (auto entry = CellStart[cell]; entry < CellStart[cell + 1]; entry++)
+				{
+					const auto id = Entries[entry];
+					// A collider spanning several cells would otherwise be visited once per cell.
+					if (multipleCells)
+					{
+						if (VisitedStamp[id] == QueryStamp)
+							continue;
+						VisitedStamp[id] = QueryStamp;
+					}
+
+					if (visit(id))
+						return;
+				}
+			}
+		}
+	}
+
+	std::size_t getCellCount() const { return static_cast<std::size_t>(Columns) * static_cast<std::size_t>(Rows); }
+
+private:
+	struct CellRange
+	{
+		int MinX{};
+		int MinY{};
+		int MaxX{};
+		int MaxY{};
+	};
+
+	struct PendingEntry
+	{
+		std::uint32_t Cell{};
+		std::uint32_t Id{};
+	};
+
+	float InverseCellSize{};
+	int Columns{};
+	int Rows{};
+
+	std::vector<PendingEntry> Pending;
+	std::vector<std::uint32_t> CellStart; // Entries of cell c are [CellStart[c], CellStart[c + 1])
+	std::vector<std::uint32_t> Entries;
+	std::vector<std::uint32_t> WriteCursor;
+
+	mutable std::vector<std::uint32_t> VisitedStamp;
+	mutable std::uint32_t QueryStamp{};
+
+	CellRange getCellRange(const sf::FloatRect& bounds) const;
+};
@@ -0,0 +1,137 @@
+#include "Systems.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+
+#include "Log.h"
+
+void patrolEnemies(JobSystem& jobs, EnemyArchetype& enemies, float deltaSeconds)
+{
+	const auto enemyVelocity = enemySpeed * deltaSeconds;
+	const sf::Vector2f enemyMovement{ 0, enemyVelocity };
+
+	const auto patrolChunk = [&](std::size_t count, CircleCollider* bodies, Patrol* patrols)
+	{
+		for (std::size_t i = 0; i < count; i++)
+		{
+			const auto enemyTop = bodies[i].getBounds().position.y;
+			if (enemyTop + 100 > windowHeight)
+				patrols[i].IsPathingDown = false;
+
+			if (enemyTop - 100 < 0)
+				patrols[i].IsPathingDown = true;
+
+			bodies[i].move(patrols[i].IsPathingDown ? enemyMovement : -enemyMovement);
+		}
+	};
+
+	enemies.parallelForEachChunk<CircleCollider, Patrol>(jobs, parallelChunkSize, patrolChunk);
+}
+
+void confineToArea(CircleCollider& body, sf::FloatRect area)
+{
+	const auto radius = body.getRadius();
+	auto center = body.getCenter();
+	center.x = std::max(area.position.x + radius, std::min(center.x, area.position.x + area.size.x - radius));
+	center.y = std::max(area.position.y + radius, std::min(center.y, area.position.y + area.size.y - radius));
+	body.setCenter(center);
+}
+
+void expireProjectiles(ProjectilePool& projectiles, float lifetime)
+{
+	for (std::size_t i = 0; i < projectiles.size(); i++)
+	{
+		if (projectiles.Age[i] >= lifetime)
+			projectiles.Flags[i] |= ProjectileFlags::Expired;
+	}
+}
+
+std::size_t collideProjectiles(PlayerProjectiles& projectiles, EnemyArchetype& enemies, SpatialGrid& enemyGrid, CollisionMode mode)
+{
+	const bool continuous = mode == CollisionMode::Continuous;
+	auto& bodies = enemies.column<CircleCollider>();
+	const auto& previousCenters = enemies.column<PreviousCenter>();
+	auto& healths = enemies.column<Health>();
+
+	enemyGrid.clear();
+	for (std::size_t i = 0; i < enemies.size(); i++)
+	{
+		const auto& body = bodies[i];
+		enemyGrid.insert(static_cast<std::uint32_t>(i), continuous
+			? CircleCollider::getSweptBounds(previousCenters[i].Value, body.getCenter(), body.getRadius())
+			: body.getBounds());
+	}
+	enemyGrid.build();
+
+	std::size_t hits = 0;
+	projectiles.forEach([&](auto& bucket)
+	{
+		auto& pool = bucket.Projectiles;
+		for (std::size_t i = 0; i < pool.size(); i++)
+		{
+			if (pool.Flags[i] & ProjectileFlags::Hit)
+				continue;
+
+			const sf::Vector2f projectileCenter{ pool.X[i], pool.Y[i] };
+			const sf::Vector2f projectilePreviousCenter{ pool.PreviousX[i], pool.PreviousY[i] };
+			const auto projectileRadius = pool.Radius[i];
+
+			std::optional<std::uint32_t> hitEnemy;
+			if (continuous)
+			{
+				// Of every enemy the projectile's path crosses, the one it reaches first takes the hit.
+				auto earliestImpact = 2.f;
+				const auto sweptBounds = CircleCollider::getSweptBounds(projectilePreviousCenter, projectileCenter, projectileRadius);
+				enemyGrid.query(sweptBounds, [&](std::uint32_t enemyIndex)
+				{
+					// Already killed earlier this step, removed by the caller.
+					if (healths[enemyIndex].Hp <= 10)
+						return false;
+
+					const auto impact = CircleCollider::sweep(
+						projectilePreviousCenter, projectileCenter, projectileRadius,
+						previousCenters[enemyIndex].Value, bodies[enemyIndex].getCenter(), bodies[enemyIndex].getRadius());
+					if (impact && *impact < earliestImpact)
+					{
+						earliestImpact = *impact;
+						hitEnemy = enemyIndex;
+					}
+					return false;
+				});
+			}
+			else
+			{
+				const sf::FloatRect projectileBounds
+				{
+					{ projectileCenter.x - projectileRadius, projectileCenter.y - projectileRadius },
+					{ projectileRadius * 2, projectileRadius * 2 }
+				};
+
+				enemyGrid.query(projectileBounds, [&](std::uint32_t enemyIndex)
+				{
+					if (healths[enemyIndex].Hp <= 10)
+						return false;
+
+					if (!CircleCollider::intersects(bodies[enemyIndex].getCenter(), bodies[enemyIndex].getRadius(), projectileCenter, projectileRadius))
+						return false;
+
+					hitEnemy = enemyIndex;
+					return true;
+				});
+			}
+
+			if (!hitEnemy)
+				continue;
+
+			auto& health = healths[*hitEnemy];
+			health.Hp -= 10;
+			hits++;
+			LOG_DEBUG("Enemy hp: {}", health.Hp);
+
+			pool.Flags[i] |= ProjectileFlags::Hit | ProjectileFlags::Expired;
+		}
+	});
+
+	return hits;
+}
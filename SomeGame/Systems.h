@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+
+#include "CircleRenderer.h"
+#include "Components.h"
+#include "GameConfig.h"
+#include "JobSystem.h"
+#include "SpatialGrid.h"
+
+// Systems are free functions over archetype columns. The templates run on any
+// archetype that has the components they need.
+
+template <typename ArchetypeType>
+void storePreviousCenters(ArchetypeType& archetype)
+{
+	archetype.template forEach<CircleCollider, PreviousCenter>([](const CircleCollider& body, PreviousCenter& previous)
+	{
+		previous.Value = body.getCenter();
+	});
+}
+
+// Keeps the collider fully inside area.
+void confineToArea(CircleCollider& body, sf::FloatRect area);
+
+// Adds the circles of an archetype, blended between the last two steps, to renderer.
+template <typename ArchetypeType>
+void extractCircles(const ArchetypeType& archetype, float interpolation, CircleRenderer& renderer)
+{
+	const auto& bodies = archetype.template column<CircleCollider>();
+	const auto& previous = archetype.template column<PreviousCenter>();
+	const auto& appearances = archetype.template column<Appearance>();
+
+	for (std::size_t i = 0; i < archetype.size(); i++)
+	{
+		const auto center = previous[i].Value + (bodies[i].getCenter() - previous[i].Value) * interpolation;
+		renderer.appendCircle(center, bodies[i].getRadius(), appearances[i].Color);
+
+		if constexpr (ArchetypeType::template has<CenterMarker>)
+		{
+			const auto& marker = archetype.template get<CenterMarker>(i);
+			renderer.appendCircle(center, marker.Radius, marker.Color);
+		}
+	}
+}
+
+// Moves enemies up and down between the top and bottom of the window.
+void patrolEnemies(JobSystem& jobs, EnemyArchetype& enemies, float deltaSeconds);
+
+// Flags projectiles older than lifetime as expired.
+void expireProjectiles(ProjectilePool& projectiles, float lifetime);
+
+// Damages the enemy each live projectile hits and expires the projectile.
+// The grid is rebuilt from the enemies here. Returns the number of hits.
+std::size_t collideProjectiles(PlayerProjectiles& projectiles, EnemyArchetype& enemies, SpatialGrid& enemyGrid, CollisionMode mode);
@@ -0,0 +1,184 @@
+#include "Trace.h"
+
+#if SOMEGAME_TRACING
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	constexpr std::size_t zonesPerThread = 1 << 16;
+	// The writer may be overwriting the oldest zones while a trace is
+	// written, so that many of them are left out.
+	constexpr std::size_t overwriteMargin = 1024;
+
+	// Written by its own thread only; the fields are atomics so another
+	// thread can read them while writing a trace without a data race.
+	struct TraceEvent
+	{
+		std::atomic<const char*> Name{};
+		std::atomic<std::uint64_t> Start{};
+		std::atomic<std::uint64_t> End{};
+		std::atomic<double> Value{};
+		std::atomic<bool> IsCounter{};
+	};
+
+	struct ThreadTrace
+	{
+		std::array<TraceEvent, zonesPerThread> Events{};
+		std::atomic<std::uint64_t> Written{}; // total zones ever recorded
+		std::atomic<const char*> Name{};
+		std::uint32_t Id{};
+	};
+
+	struct TraceRegistry
+	{
+		std::mutex Mutex;
+		std::vector<std::shared_ptr<ThreadTrace>> Threads;
+	};
+
+	TraceRegistry& getRegistry()
+	{
+		static TraceRegistry registry;
+		return registry;
+	}
+
+	// Registered on first use; the registry keeps it alive after the thread exits.
+	ThreadTrace& getThreadTrace()
+	{
+		thread_local const std::shared_ptr<ThreadTrace> trace = []
+		{
+			auto created = std::make_shared<ThreadTrace>();
+			auto& registry = getRegistry();
+			std::lock_guard lock{ registry.Mutex };
+			created->Id = static_cast<std::uint32_t>(registry.Threads.size());
+			registry.Threads.push_back(created);
+			return created;
+		}();
+		return *trace;
+	}
+
+	void writeJsonString(std::ofstream& file, const char* text)
+	{
+		file << '"';
+		for (; *text; text++)
+		{
+			if (*text == '"' || *text == '\\')
+				file << '\\';
+			file << *text;
+		}
+		file << '"';
+	}
+}
+
+std::uint64_t getTraceTimestamp()
+{
+	using Clock = std::chrono::steady_clock;
+	static const auto epoch = Clock::now();
+	return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count());
+}
+
+void recordTraceZone(const char* name, std::uint64_t start, std::uint64_t end)
+{
+	auto& trace = getThreadTrace();
+	const auto index = trace.Written.load(std::memory_order_relaxed);
+	auto& event = trace.Events[index % zonesPerThread];
+	event.Name.store(name, std::memory_order_relaxed);
+	event.Start.store(start, std::memory_order_relaxed);
+	event.End.store(end, std::memory_order_relaxed);
+	event.IsCounter.store(false, std::memory_order_relaxed);
+	trace.Written.store(index + 1, std::memory_order_release);
+}
+
+void recordTraceCounter(const char* name, std::uint64_t timestamp, double value)
+{
+	auto& trace = getThreadTrace();
+	const auto index = trace.Written.load(std::memory_order_relaxed);
+	auto& event = trace.Events[index % zonesPerThread];
+	event.Name.store(name, std::memory_order_relaxed);
+	event.Start.store(timestamp, std::memory_order_relaxed);
+	event.Value.store(value, std::memory_order_relaxed);
+	event.IsCounter.store(true, std::memory_order_relaxed);
+	trace.Written.store(index + 1, std::memory_order_release);
+}
+
+void setTraceThreadName(const char* name)
+{
+	getThreadTrace().Name.store(name, std::memory_order_relaxed);
+}
+
+bool writeChromeTrace(const std::string& path, std::uint64_t since)
+{
+	std::vector<std::shared_ptr<ThreadTrace>> threads;
+	{
+		auto& registry = getRegistry();
+		std::lock_guard lock{ registry.Mutex };
+		threads = registry.Threads;
+	}
+
+	std::ofstream file{ path };
+	if (!file)
+		return false;
+
+	// Chrome trace timestamps are in microseconds.
+	file << std::fixed << std::setprecision(3);
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	const auto separate = [&] { file << (first ? "\n" : ",\n"); first = false; };
+
+	for (const auto& thread : threads)
+	{
+		if (const auto* name = thread->Name.load(std::memory_order_relaxed))
+		{
+			separate();
+			file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->Id << ",\"args\":{\"name\":";
+			writeJsonString(file, name);
+			file << "}}";
+		}
+
+		const auto written = thread->Written.load(std::memory_order_acquire);
+		const auto kept = zonesPerThread - overwriteMargin;
+		for (auto index = written > kept ? written - kept : 0; index < written; index++)
+		{
+			const auto& event = thread->Events[index % zonesPerThread];
+			const auto start = event.Start.load(std::memory_order_relaxed);
+			const auto end = event.End.load(std::memory_order_relaxed);
+			if (start < since)
+				continue;
+
+			separate();
+			file << "{\"name\":";
+			writeJsonString(file, event.Name.load(std::memory_order_relaxed));
+			if (event.IsCounter.load(std::memory_order_relaxed))
+			{
+				file << ",\"ph\":\"C\",\"pid\":1,\"tid\":" << thread->Id
+					<< ",\"ts\":" << static_cast<double>(start) / 1000.0
+					<< ",\"args\":{\"value\":" << event.Value.load(std::memory_order_relaxed) << "}}";
+				continue;
+			}
+
+			file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->Id
+				<< ",\"ts\":" << static_cast<double>(start) / 1000.0
+				<< ",\"dur\":" << static_cast<double>(end - start) / 1000.0 << "}";
+		}
+	}
+
+	file << "\n]}\n";
+	return static_cast<bool>(file);
+}
+
+#else
+
+std::uint64_t getTraceTimestamp() { return 0; }
+void recordTraceZone(const char*, std::uint64_t, std::uint64_t) {}
+void recordTraceCounter(const char*, std::uint64_t, double) {}
+void setTraceThreadName(const char*) {}
+bool writeChromeTrace(const std::string&, std::uint64_t) { return false; }
+
+#endif
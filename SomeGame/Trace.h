@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Scoped trace zones for seeing where a frame goes:
+//	void update()
+//	{
+//		TRACE_ZONE("update");
+//		...
+//	}
+// records when the zone was entered and how long it took. Every thread
+// writes to its own ring buffer without locks, keeping the most recent
+// zones, and writeChromeTrace() saves all of them as a Chrome trace that
+// chrome://tracing and ui.perfetto.dev open.
+// Zone and counter names have to be string literals or otherwise outlive
+// the trace.
+//
+// Build with SOMEGAME_TRACING=0 to compile every zone out.
+
+#ifndef SOMEGAME_TRACING
+#define SOMEGAME_TRACING 1
+#endif
+
+// Nanoseconds since the first call, on a monotonic clock.
+std::uint64_t getTraceTimestamp();
+
+// Records a zone on the calling thread.
+void recordTraceZone(const char* name, std::uint64_t start, std::uint64_t end);
+
+// Records a value of the counter track name, drawn as a graph over time.
+void recordTraceCounter(const char* name, std::uint64_t timestamp, double value);
+
+// Names the calling thread in the trace.
+void setTraceThreadName(const char* name);
+
+// Saves the zones that started at or after since, a getTraceTimestamp() value.
+// Returns false when the file can't be written or tracing is compiled out.
+bool writeChromeTrace(const std::string& path, std::uint64_t since = 0);
+
+#if SOMEGAME_TRACING
+
+class TraceZone
+{
+public:
+	explicit TraceZone(const char* name)
+		: Name(name), Start(getTraceTimestamp())
+	{
+	}
+
+	~TraceZone()
+	{
+		recordTraceZone(Name, Start, getTraceTimestamp());
+	}
+
+	TraceZone(const TraceZone&) = delete;
+	TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+	const char* Name;
+	std::uint64_t Start;
+};
+
+#define SOMEGAME_TRACE_CONCAT_INNER(a, b) a##b
+#define SOMEGAME_TRACE_CONCAT(a, b) SOMEGAME_TRACE_CONCAT_INNER(a, b)
+#define TRACE_ZONE(name) const TraceZone SOMEGAME_TRACE_CONCAT(traceZone, __LINE__){ name }
+
+#else
+
+#define TRACE_ZONE(name) ((void)0)
+
+#endif
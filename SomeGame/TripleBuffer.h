@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+// Hands whole values from one producer thread to one consumer thread without
+// either of them copying. The producer fills the write buffer and publishes
+// it; the consumer takes the newest published buffer and keeps reading it
+// until it takes the next one. The three buffers never alias, so neither side
+// holds the lock while it works on its buffer.
+template <typename T>
+class TripleBuffer
+{
+public:
+	T& getWriteBuffer() { return Buffers[Write]; }
+
+	// Makes the write buffer the newest one. A published buffer the consumer
+	// hasn't taken yet is dropped and becomes the next write buffer.
+	void publish()
+	{
+		{
+			std::lock_guard lock{ Mutex };
+			std::swap(Write, Ready);
+			HasPublished = true;
+		}
+		Changed.notify_all();
+	}
+
+	// Blocks the producer until the consumer has taken the last published
+	// buffer, so it runs at most one buffer ahead. Returns false once stopped.
+	bool waitUntilTaken()
+	{
+		std::unique_lock lock{ Mutex };
+		Changed.wait(lock, [this] { return !HasPublished || Stopped; });
+		return !Stopped;
+	}
+
+	// Blocks the consumer until a buffer is published and returns it, or
+	// returns nullptr once stopped.
+	const T* acquire()
+	{
+		{
+			std::unique_lock lock{ Mutex };
+			Changed.wait(lock, [this] { return HasPublished || Stopped; });
+			if (Stopped)
+				return nullptr;
+
+			std::swap(Read, Ready);
+			HasPublished = false;
+		}
+		Changed.notify_all();
+		return &Buffers[Read];
+	}
+
+	// Wakes both sides up for good.
+	void stop()
+	{
+		{
+			std::lock_guard lock{ Mutex };
+			Stopped = true;
+		}
+		Changed.notify_all();
+	}
+
+private:
+	std::array<T, 3> Buffers{};
+	std::size_t Write = 0;
+	std::size_t Ready = 1;
+	std::size_t Read = 2;
+	bool HasPublished{};
+	bool Stopped{};
+	std::mutex Mutex;
+	std::condition_variable Changed;
+};
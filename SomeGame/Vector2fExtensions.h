@@ -0,0 +1,18 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+
+namespace sf
+{
+	static const sf::Vector2f VectorZero{ 0, 0 };
+
+	class Vector2fExtensions
+	{
+	public:
+		static bool isOutOfBounds(const sf::Vector2f& vector, const sf::Vector2f& bounds)
+		{
+			return vector.x < 0 || vector.x > bounds.x
+				|| vector.y < 0 || vector.y > bounds.y;
+		}
+	};
+}
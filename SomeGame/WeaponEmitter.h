@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+
+// Fires shots at a fixed rate however long the steps are. The time until the
+// next shot carries over between steps, so every shot that falls due within
+// a step is fired, each with how far into the step it happened. Spawning a
+// projectile that much later along its path keeps the spacing between shots
+// even at rates well above the step rate.
+class WeaponEmitter
+{
+public:
+	explicit WeaponEmitter(float shotInterval)
+		: ShotInterval(shotInterval)
+	{
+		assert(shotInterval > 0.f);
+	}
+
+	// Calls fire(delaySeconds) for each shot due in this step, in order,
+	// where delaySeconds is the time from the start of the step to the shot.
+	// Returns how many shots were fired. The first shot after the trigger was
+	// let go fires as soon as the interval since the last one has passed.
+	template <typename Fire>
+	int update(float deltaSeconds, bool triggerHeld, Fire&& fire)
+	{
+		if (!triggerHeld)
+		{
+			Cooldown = std::max(Cooldown - deltaSeconds, 0.f);
+			return 0;
+		}
+
+		int shots = 0;
+		// Multiplying instead of adding the interval up doesn't drift over many shots.
+		for (auto shotTime = Cooldown; shotTime < deltaSeconds; shotTime = Cooldown + static_cast<float>(shots) * ShotInterval)
+		{
+			fire(shotTime);
+			shots++;
+		}
+
+		Cooldown += static_cast<float>(shots) * ShotInterval - deltaSeconds;
+		return shots;
+	}
+
+	float getShotInterval() const { return ShotInterval; }
+	// Time until the weapon can fire again, 0 when it's ready.
+	float getCooldown() const { return Cooldown; }
+
+private:
+	float ShotInterval{};
+	float Cooldown{};
+};
@@ -1,130 +1,102 @@
+#include <cstdlib>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <SFML/Graphics.hpp>
 
-namespace sf
-{
-	static const sf::Vector2f VectorZero{ 0, 0 };
-
-	class Vector2fExtensions
-	{
-	public:
-		static bool isOutOfBounds(const sf::Vector2f& vector, const sf::Vector2f& bounds)
-		{
-			return vector.x < 0 || vector.x > bounds.x
-				|| vector.y < 0 || vector.y > bounds.y;
-		}
-	};
-}
+#include "Benchmarks.h"
+#include "BulletPattern.h"
+#include "FixedTimestep.h"
+#include "FrameTimings.h"
+#include "GameConfig.h"
+#include "Headless.h"
+#include "HitchDetector.h"
+#include "InputCache.h"
+#include "InputRecording.h"
+#include "JobSystem.h"
+#include "Log.h"
+#include "PerfCounters.h"
+#include "RenderThread.h"
+#include "Simulation.h"
+#include "Trace.h"
 
+sf::Clock mainClock;
 
-//struct MovementBase
-//{
-//	virtual sf::Vector2f getVector() const = 0;
-//};
-
-struct FixedMovement
-{
-	sf::CircleShape ProjectileShape{};
-	sf::Vector2f TargetPosition{};
-	float ProjectileMovementSpeed{};
-
-	FixedMovement(
-		sf::CircleShape projectileShape,
-		sf::Vector2f targetPosition,
-		float projectileMovementSpeed)
-		: ProjectileShape(projectileShape),
-		TargetPosition(targetPosition),
-		ProjectileMovementSpeed(projectileMovementSpeed)
-	{
-	}
-
-	sf::Vector2f getVector(sf::Time deltaTime) const
-	{
-		auto difference = TargetPosition - ProjectileShape.getPosition();
-		return difference == sf::VectorZero ? sf::VectorZero
-			: sf::Vector2f(ProjectileMovementSpeed * deltaTime.asSeconds(), difference.angle()); // can't calculate angle of VectorZero, throws Assertion failed
-	}
-};
-
-struct Debugger
-{
-	sf::CircleShape Shape{};
-
-	Debugger() {}
+sf::Clock overlayClock;
+const sf::Time overlayRefreshInterval = sf::milliseconds(500);
 
-	Debugger(float radius, sf::Color fillColor)
-	{
-		Shape = sf::CircleShape{ radius };
-		Shape.setFillColor(fillColor);
-		Shape.setOrigin(sf::Vector2f{ radius, radius });
-	}
-};
-
-struct Player
+int main(int argc, char* argv[])
 {
-	sf::CircleShape Shape{};
-	Debugger CenterDebugger{};
-
-	Player(float radius, sf::Color fillColor, Debugger centerDebugger)
+	if (argc > 1 && std::string_view{ argv[1] } == "--bench-kernels")
+		return runKernelBenchmark();
+	if (argc > 1 && std::string_view{ argv[1] } == "--bench-render")
+		return runRenderBenchmark();
+	if (argc > 1 && std::string_view{ argv[1] } == "--bench-trig")
+		return runTrigBenchmark();
+	if (argc > 1 && std::string_view{ argv[1] } == "--headless")
+		return runHeadless(argc, argv);
+
+	auto hitchBudget = hitchBudgetMilliseconds;
+	std::string recordPath;
+	std::string replayPath;
+	std::string playerPattern;
+	std::string enemyPattern;
+	for (int i = 1; i + 1 < argc; i++)
 	{
-		Shape = sf::CircleShape{ radius };
-		Shape.setFillColor(fillColor);
-		CenterDebugger = centerDebugger;
-		CenterDebugger.Shape.setPosition(
-			Shape.getGlobalBounds().getCenter());
+		const std::string_view argument{ argv[i] };
+		if (argument == "--hitch-budget")
+			hitchBudget = std::strtof(argv[++i], nullptr);
+		else if (argument == "--record")
+			recordPath = argv[++i];
+		else if (argument == "--replay")
+			replayPath = argv[++i];
+		else if (argument == "--pattern" || argument == "--player-pattern")
+		{
+			if (findBulletPattern(argv[++i]))
+				(argument == "--pattern" ? enemyPattern : playerPattern) = argv[i];
+			else
+				std::cerr << "Unknown bullet pattern " << argv[i] << ", try radial, spiral, fan or burst\n";
+		}
 	}
 
-	void move(sf::Vector2f movement)
+	// --record saves every step's input when the window closes; --replay
+	// drives the simulation from a recording and hands back to live input
+	// once it runs out.
+	InputRecording recording{};
+	std::optional<InputRecording> replay;
+	auto stepSeconds = 1.f / simulationRate;
+	if (!replayPath.empty())
 	{
-		Shape.move(movement);
-		CenterDebugger.Shape.setPosition(
-			Shape.getGlobalBounds().getCenter());
-	}
-};
-
-struct Enemy
-{
-	sf::CircleShape Shape{};
-	int Hp{};
-	bool IsEnemyPathingDown = true;
+		replay = InputRecording::load(replayPath);
+		if (!replay)
+		{
+			std::cerr << "Can't read input recording " << replayPath << "\n";
+			return 1;
+		}
 
-	Enemy(float radius, sf::Color fillColor, int hp)
-	{
-		Shape = sf::CircleShape{ radius };
-		Shape.setFillColor(fillColor);
-		Hp = hp;
+		// A replay has to step exactly as long as the recorded steps.
+		stepSeconds = replay->StepSeconds;
+		if (replay->Kernel != detectKernelLevel())
+			std::cerr << "Recorded with " << toString(replay->Kernel) << " kernels, replaying with "
+				<< toString(detectKernelLevel()) << ", the state may drift\n";
+		if (const auto error = adoptRecordedPatterns(*replay, enemyPattern, playerPattern))
+		{
+			std::cerr << *error << "\n";
+			return 1;
+		}
+		// The window always plays the default scenario.
+		Scenario windowScenario{};
+		if (const auto error = adoptRecordedScenario(*replay, windowScenario, true))
+		{
+			std::cerr << *error << ", replay it with --headless\n";
+			return 1;
+		}
 	}
-};
-
-struct Projectile
-{
-	sf::CircleShape ProjectileShape{};
-	FixedMovement Movement;
-};
-
-constexpr int windowWidth = 800;
-constexpr int windowHeight = 600;
-const sf::Vector2f windowSize
-{
-	static_cast<float>(windowWidth),
-	static_cast<float>(windowHeight)
-};
-
-constexpr float playerRadius = 50.f;
-constexpr float playerSpeed = 200.f;
-constexpr float projectileSpeed = 1000.f;
-
-constexpr float enemySpeed = 300.f;
-constexpr int enemyHp = 100;
-
-sf::Clock mainClock;
-sf::Clock projectileSpawningClock;
-
-sf::Clock fpsDrawingClock;
-const sf::Time fpsCalculationInterval = sf::milliseconds(500);
+	std::optional<InputPlayback> playback;
+	if (replay)
+		playback.emplace(*replay);
 
-int main()
-{
 	sf::ContextSettings settings;
 	settings.antiAliasingLevel = 8;
 
@@ -134,159 +106,180 @@ int main()
 		sf::Style::Default,
 		sf::State::Windowed,
 		settings);
-
-	Debugger debugger{ playerRadius / 100 * 10 , sf::Color::Red };
-	Player player{ playerRadius, sf::Color::Blue, debugger };
-
-	sf::Font font{ "resources/fonts/Caliban.ttf" };
-	sf::Text text(font, "FPS: ", 20);
-	text.setFillColor(sf::Color::White);
-	text.setPosition(sf::Vector2f{ 10.f, 10.f });
-
-	std::vector<Projectile> projectiles;
-	sf::CircleShape projectileBlueprint{ 5.f };
-	projectileBlueprint.setFillColor(sf::Color::White);
-	projectileBlueprint.setPosition(player.Shape.getGlobalBounds().getCenter());
-	projectileBlueprint.setOrigin(sf::Vector2f{ 5.f, 5.f });
-
-	//std::vector<Enemy> enemies;
-
-	Enemy* enemy = new Enemy{ 15.f, sf::Color::Red, enemyHp };
-	enemy->Shape.setPosition(sf::Vector2f{ 400.f, 400.f });
-	//enemies.push_back(enemy);
+	window.setKeyRepeatEnabled(false);
+
+	JobSystem jobs;
+	Simulation simulation{ jobs };
+	if (!playerPattern.empty())
+		simulation.PlayerPattern.emplace(*findBulletPattern(playerPattern));
+	if (!enemyPattern.empty())
+		simulation.EnemyPattern.emplace(*findBulletPattern(enemyPattern));
+	RenderThread renderThread{ window };
+
+	FrameTimings timings;
+	std::string timingText;
+	sf::Clock phaseClock;
+	// Restarted together with phaseClock after the Extract phase, so a frame's
+	// time covers exactly the phases recorded for it.
+	sf::Clock frameClock;
+	HitchDetector hitchDetector{ hitchBudget, hitchHistorySeconds, hitchCooldownSeconds };
+
+	// Hardware counters are summed over the overlay interval and shown per frame.
+	const bool perfCounters = arePerfCountersAvailable();
+	PerfTotals overlayPerfTotals{};
+	std::size_t overlayFrames{};
+
+	FixedTimestep timestep{ stepSeconds, maxSimulationStepsPerFrame };
+	// Input comes from the window's events; nothing asks the OS for key state.
+	InputCache inputCache;
+	inputCache.setMousePosition(sf::Mouse::getPosition(window));
+	InputState input{};
+	// A fire press no step has seen yet. Only the next step fires for it, so
+	// a click shorter than a frame fires once instead of in every catch-up
+	// step, and a frame without steps keeps it.
+	bool firePressed = false;
+	setTraceThreadName("main");
 
 	while (window.isOpen())
 	{
-		while (const std::optional event = window.pollEvent())
-		{
-			if (event->is<sf::Event::Closed>())
-				window.close();
-		}
+		TRACE_ZONE("frame");
 
-		sf::Time deltaTime = mainClock.restart();
-
-		if (enemy != nullptr)
 		{
-			auto enemyPosition = enemy->Shape.getPosition();
-			const auto enemyVelocity = enemySpeed * deltaTime.asSeconds();
-			if (enemyPosition.y + 100 > windowHeight)
-				enemy->IsEnemyPathingDown = false;
-
-			if (enemyPosition.y - 100 < 0)
-				enemy->IsEnemyPathingDown = true;
+			TRACE_ZONE("poll events");
+			while (const std::optional event = window.pollEvent())
+			{
+				if (event->is<sf::Event::Closed>())
+				{
+					renderThread.stop();
+					window.close();
+				}
 
-			const sf::Vector2f enemyMovement{ 0, enemyVelocity };
-			enemy->Shape.move(enemy->IsEnemyPathingDown ? enemyMovement : -enemyMovement);
+				inputCache.handleEvent(*event);
+			}
 		}
 
-		sf::Vector2f playerMovement = sf::VectorZero;
-		const auto playerVelocity = playerSpeed * deltaTime.asSeconds();
-
-		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W))
-			playerMovement.y -= playerVelocity;
-		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A))
-			playerMovement.x -= playerVelocity;
-		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S))
-			playerMovement.y += playerVelocity;
-		if (sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D))
-			playerMovement.x += playerVelocity;
+		if (!window.isOpen())
+			break;
 
-		player.move(playerMovement);
-		projectileBlueprint.setPosition(
-			player.Shape.getGlobalBounds().getCenter());
+		sf::Time deltaTime = mainClock.restart();
 
-		if (sf::Mouse::isButtonPressed(sf::Mouse::Button::Left)
-			&& projectileSpawningClock.getElapsedTime().asMilliseconds() > 100)
 		{
-			projectileSpawningClock.restart();
-
-			const auto mousePosition = sf::Mouse::getPosition(window);
-			const FixedMovement projectileMovement
-			{
-				projectileBlueprint,
-				static_cast<sf::Vector2f>(mousePosition),
-				projectileSpeed
-			};
-			const Projectile projectile{ projectileBlueprint, projectileMovement };
-			if (projectile.Movement.getVector(deltaTime) != sf::VectorZero)
+			TRACE_ZONE("input");
+			input.MoveUp = inputCache.isDown(Action::MoveUp);
+			input.MoveLeft = inputCache.isDown(Action::MoveLeft);
+			input.MoveDown = inputCache.isDown(Action::MoveDown);
+			input.MoveRight = inputCache.isDown(Action::MoveRight);
+			input.Fire = inputCache.isDown(Action::Fire);
+			firePressed = firePressed || inputCache.wasPressed(Action::Fire);
+			input.AimPosition = static_cast<sf::Vector2f>(inputCache.getMousePosition());
+
+			static_assert(PlayerProjectiles::bucketCount <= selectMovementActionCount, "Every movement model needs an action to select it");
+			for (std::size_t movement = 0; movement < PlayerProjectiles::bucketCount; movement++)
 			{
-				projectiles.push_back(projectile);
+				if (inputCache.wasPressed(getSelectMovementAction(movement)))
+					input.SelectMovement = movement;
 			}
-		}
-
-		const auto bounds = player.Shape.getGlobalBounds();
-		auto position = player.Shape.getPosition();
 
-		if (position.x + bounds.size.x > windowWidth)
-			position.x = windowWidth - bounds.size.x;
+			// F5 and F6 save the frame times to compare builds.
+			if (inputCache.wasPressed(Action::SaveTimingsCsv) && timings.exportCsv("frame_timings.csv"))
+				LOG_INFO("Saved frame_timings.csv");
+			if (inputCache.wasPressed(Action::SaveTimingsJson) && timings.exportJson("frame_timings.json"))
+				LOG_INFO("Saved frame_timings.json");
+			if (inputCache.wasPressed(Action::SaveTrace) && writeChromeTrace("trace.json"))
+				LOG_INFO("Saved trace.json");
 
-		if (position.y + bounds.size.y > windowHeight)
-			position.y = windowHeight - bounds.size.y;
-
-		if (position.x < 0)
-			position.x = 0;
-
-		if (position.y < 0)
-			position.y = 0;
-
-		player.Shape.setPosition(position);
-
-		window.clear(sf::Color::Black);
-
-		window.draw(player.Shape);
-		window.draw(player.CenterDebugger.Shape);
+			inputCache.endFrame();
+		}
+		timings.record(FramePhase::Input, phaseClock.restart().asSeconds());
 
-		for (auto i = 0; i < projectiles.size(); i++)
+		const auto steps = timestep.advance(deltaTime.asSeconds());
+		for (int step = 0; step < steps; step++)
 		{
-			auto& projectile = projectiles[i];
-
-			if (enemy != nullptr && enemy->Shape.getGlobalBounds()
-				.findIntersection(projectile.ProjectileShape.getGlobalBounds()))
+			auto stepInput = input;
+			stepInput.Fire = input.Fire || firePressed;
+			if (playback)
 			{
-				enemy->Hp -= 10;
-				std::cout << "Enemy hp: " << enemy->Hp << std::endl;
-				if (enemy->Hp <= 10)
-				{
-					enemy = nullptr;
-				}
-
-				projectiles.erase(projectiles.begin() + i);
-				continue;
+				if (const auto replayed = playback->next())
+					stepInput = *replayed;
 			}
 
-			if (const auto isOutOfBound = sf::Vector2fExtensions::isOutOfBounds(
-				projectile.ProjectileShape.getPosition(), windowSize))
+			simulation.step(timestep.getStepSeconds(), stepInput);
+			if (!recordPath.empty())
+				recording.record(stepInput);
+			input.SelectMovement.reset();
+			firePressed = false;
+
+			if (playback && playback->isFinished())
 			{
-				projectiles.erase(projectiles.begin() + i);
-				continue;
+				if (simulation.computeChecksum() == replay->FinalChecksum)
+					LOG_INFO("Replay ended in the recorded state");
+				else
+					LOG_WARNING("Replay ended in a different state than recorded");
+				playback.reset();
 			}
+		}
+		timings.record(FramePhase::Simulation, phaseClock.restart().asSeconds());
 
-			projectile.ProjectileShape.move(
-				projectile.Movement.getVector(deltaTime));
-
-			window.draw(projectile.ProjectileShape);
+		if (perfCounters)
+		{
+			const auto perfTotals = takePerfTotals();
+			tracePerfTotals(perfTotals);
+			for (std::size_t phase = 0; phase < perfPhaseCount; phase++)
+				overlayPerfTotals[phase] += perfTotals[phase];
 		}
+		overlayFrames++;
 
-		if (enemy != nullptr)
+		if (overlayClock.getElapsedTime() >= overlayRefreshInterval)
 		{
-			window.draw(enemy->Shape);
+			overlayClock.restart();
+			timingText = formatStatistics(timings.getStatistics());
+			if (perfCounters)
+				timingText += formatPerfTotals(overlayPerfTotals, overlayFrames);
+			overlayPerfTotals = {};
+			overlayFrames = 0;
 		}
 
-		/*for (auto& enemy : enemies)
-		{*/
-		//}
+		// Entities are drawn where they were between the last two steps, so
+		// motion stays smooth when the render rate doesn't match the simulation rate.
+		// The render thread is still drawing the previous snapshot while the
+		// steps above run; filling this one waits until it has taken that.
+		auto* snapshot = renderThread.getSnapshot();
+		if (!snapshot)
+		{
+			// The render thread gave up, nothing would be drawn any more.
+			renderThread.stop();
+			window.close();
+			break;
+		}
+		timings.record(FramePhase::Wait, phaseClock.restart().asSeconds());
 
-		if (fpsDrawingClock.getElapsedTime() >= fpsCalculationInterval)
 		{
-			fpsDrawingClock.restart();
-			float fps = 1.f / deltaTime.asSeconds();
-			text.setString("FPS: " + std::to_string(static_cast<int>(fps)));
+			TRACE_ZONE("extract snapshot");
+			snapshot->extract(simulation, timestep.getInterpolation(), jobs);
+			snapshot->TimingText = timingText;
+			snapshot->TimingGraph.update(timings);
+			renderThread.publish();
 		}
+		timings.record(FramePhase::Extract, phaseClock.restart().asSeconds());
 
-		window.draw(text);
+		timings.endFrame(frameClock.restart().asSeconds());
 
-		window.display();
+		const auto& frame = timings[timings.size() - 1];
+		if (const auto hitchPath = hitchDetector.recordFrame(frame, simulation.Enemies.size(), simulation.getProjectileCount()))
+			LOG_WARNING("Frame took {} ms, saving {}", frame.FrameMilliseconds, *hitchPath);
+	}
+
+	if (!recordPath.empty())
+	{
+		recording.StepSeconds = timestep.getStepSeconds();
+		recording.EnemyPattern = enemyPattern;
+		recording.PlayerPattern = playerPattern;
+		recording.FinalChecksum = simulation.computeChecksum();
+		if (recording.save(recordPath))
+			LOG_INFO("Saved input recording to {}", recordPath);
+		else
+			LOG_ERROR("Can't write input recording to {}", recordPath);
 	}
 
 	return 0;
-}
\ No newline at end of file
+}